@@ -0,0 +1,747 @@
+//
+// Created by catboy on 3/10/2025.
+//
+#include <chrono>
+#include <random>
+
+#include "test.hpp"
+#include "ShortestPathVisitors.hpp"
+#include "FlowVisitors.hpp"
+#include "LCAVisitors.hpp"
+#include "LCAIndex.hpp"
+
+template<typename Func>
+double MeasureMs(Func &&func, int repeats = 5) {
+  double best = 0;
+  for (int i = 0; i < repeats; i++) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    double cur = std::chrono::duration<double, std::milli>(end - begin).count();
+    if (i == 0 || cur < best) best = cur;
+  }
+  return best;
+}
+
+template<typename CurGraph>
+class CountingDFSVisitor : public DFSVisitor<CurGraph> {
+ public:
+  std::size_t amount_discovered = 0;
+
+  bool discover_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+    amount_discovered++;
+    return false;
+  }
+};
+
+template<typename CurGraph>
+void BenchDFSOnGraph(const std::string &name, CurGraph &graph) {
+  CountingDFSVisitor<CurGraph> visitor;
+  double iter_ms = MeasureMs([&]() {
+    graph.ConstructColor();
+    graph.DFSIter(0, visitor);
+  });
+  double recr_ms = MeasureMs([&]() {
+    graph.ConstructColor();
+    graph.DFSRecr(0, visitor);
+  });
+  std::cout << name << ": recursive " << recr_ms << " ms, iterative " << iter_ms << " ms\n";
+}
+
+void BenchDFS() {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  std::mt19937 gen(42);
+
+  // Глубина рекурсии ограничена стеком, поэтому путь берется такой, чтобы DFSRecr еще не падал
+  const int deep_size = 30000;
+  graph_type deep_graph(deep_size);
+  for (int i = 0; i + 1 < deep_size; i++) {
+    deep_graph.AddEdge(i, i + 1);
+  }
+  BenchDFSOnGraph("DFS path " + std::to_string(deep_size), deep_graph);
+
+  const int wide_size = 200000;
+  graph_type wide_graph(wide_size);
+  for (int i = 1; i < wide_size; i++) {
+    wide_graph.AddEdge(0, i);
+  }
+  BenchDFSOnGraph("DFS star " + std::to_string(wide_size), wide_graph);
+
+  const int random_size = 20000;
+  graph_type random_graph(random_size);
+  for (int i = 0; i < random_size * 8; i++) {
+    random_graph.AddEdge(gen() % random_size, gen() % random_size);
+  }
+  BenchDFSOnGraph("DFS random " + std::to_string(random_size), random_graph);
+
+  const int huge_deep_size = 2000000;
+  graph_type huge_deep_graph(huge_deep_size);
+  for (int i = 0; i + 1 < huge_deep_size; i++) {
+    huge_deep_graph.AddEdge(i, i + 1);
+  }
+  CountingDFSVisitor<graph_type> visitor;
+  double iter_ms = MeasureMs([&]() {
+    huge_deep_graph.DFS(0, visitor);
+  }, 1);
+  std::cout << "DFS path " << huge_deep_size << ": iterative " << iter_ms << " ms (recursive overflows the stack)\n";
+}
+
+template<typename CurGraph>
+CurGraph MakeRandomWeightedGraph(int amount_vertex, std::size_t amount_edges, int max_weight, std::mt19937 &gen) {
+  CurGraph graph(amount_vertex);
+  for (std::size_t i = 0; i < amount_edges; i++) {
+    graph.AddEdge(gen() % amount_vertex, gen() % amount_vertex, 1 + gen() % max_weight);
+  }
+  return graph;
+}
+
+template<typename CurQueue, typename CurGraph>
+void BenchDejkstraQueue(const std::string &name, CurGraph &graph) {
+  DejkstraVisitor<CurGraph> visitor(0);
+  double ms = MeasureMs([&]() {
+    graph.template Dejkstra<DejkstraVisitor<CurGraph>, CurQueue>(0, visitor);
+  });
+  std::cout << "  " << name << " " << ms << " ms\n";
+}
+
+template<typename CurGraph>
+void BenchDejkstraQueues(CurGraph &graph) {
+  BenchDejkstraQueue<LazyPriorityQueue<>>("lazy std::priority_queue", graph);
+  BenchDejkstraQueue<IndexedDaryHeap<2>>("indexed 2-ary heap", graph);
+  BenchDejkstraQueue<IndexedDaryHeap<4>>("indexed 4-ary heap", graph);
+  BenchDejkstraQueue<IndexedDaryHeap<8>>("indexed 8-ary heap", graph);
+  BenchDejkstraQueue<RadixHeap<>>("radix heap", graph);
+  BenchDejkstraQueue<DialBucketQueue<100>>("Dial buckets (max weight 100)", graph);
+}
+
+template<typename CurGraph>
+class DepthBFSVisitor : public BFSVisitor<CurGraph> {
+ public:
+  std::vector<int> depth;
+  std::vector<int> predecessor;
+
+  explicit DepthBFSVisitor(int amount_vertex) : depth(amount_vertex, INT_MAXIMUS), predecessor(amount_vertex, -1) {}
+
+  void tree_edge_BFS(BFSVisitor<CurGraph>::edge_desc edge,
+                     BFSVisitor<CurGraph>::edge_desc_iter iter,
+                     BFSVisitor<CurGraph>::graph_type &graph) {
+    depth[edge.second] = depth[edge.first] + 1;
+    predecessor[edge.second] = edge.first;
+  }
+};
+
+void BenchBFS() {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  std::mt19937 gen(42);
+  const int amount_vertex = 1000000;
+  const int amount_edges = 8000000;
+
+  graph_type graph(amount_vertex);
+  for (int i = 0; i < amount_edges; i++) {
+    graph.AddEdge(gen() % amount_vertex, gen() % amount_vertex);
+  }
+  graph.GetReverseEdges();
+
+  DepthBFSVisitor<graph_type> visitor(amount_vertex);
+  double push_ms = MeasureMs([&]() {
+    visitor = DepthBFSVisitor<graph_type>(amount_vertex);
+    visitor.depth[0] = 0;
+    graph.BFS(0, visitor);
+  }, 3);
+  double direction_ms = MeasureMs([&]() { graph.DirectionOptimizingBFS(0); }, 3);
+  for (int i = 0; i < amount_vertex; i++) {
+    if (visitor.depth[i] != graph.GetDepth(i)) {
+      std::cout << "BFS depths differ\n";
+      break;
+    }
+  }
+  std::cout << "BFS random V = " << amount_vertex << " E = " << amount_edges << ": top-down " << push_ms
+            << " ms, direction-optimizing " << direction_ms << " ms\n";
+
+  std::size_t max_threads = std::max(4u, std::thread::hardware_concurrency());
+  BFSVisitor<graph_type> empty_visitor;
+  for (std::size_t amount_threads = 1; amount_threads <= max_threads; amount_threads *= 2) {
+    ThreadPool pool(amount_threads);
+    double parallel_ms = MeasureMs([&]() { graph.ParallelBFS(0, empty_visitor, pool); }, 3);
+    std::cout << "BFS random parallel, " << amount_threads << " threads: " << parallel_ms << " ms\n";
+  }
+}
+
+void BenchTraversalContext() {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  std::mt19937 gen(42);
+  const int amount_vertex = 100000;
+  const int amount_edges = 800000;
+  const int amount_queries = 256;
+
+  graph_type graph(amount_vertex);
+  for (int i = 0; i < amount_edges; i++) {
+    graph.AddEdge(gen() % amount_vertex, gen() % amount_vertex);
+  }
+  graph.GetReverseEdges();
+  std::vector<int> sources(amount_queries);
+  for (int &source : sources) {
+    source = int(gen() % amount_vertex);
+  }
+
+  double fresh_ms = MeasureMs([&]() {
+    for (int source : sources) {
+      graph_type::context_type context;
+      graph.DirectionOptimizingBFS(source, context);
+    }
+  }, 1);
+  graph_type::context_type context;
+  double reused_ms = MeasureMs([&]() {
+    for (int source : sources) {
+      graph.DirectionOptimizingBFS(source, context);
+    }
+  }, 1);
+  std::cout << "BFS " << amount_queries << " queries V = " << amount_vertex << ": new context per query "
+            << fresh_ms << " ms, reused context " << reused_ms << " ms\n";
+
+  std::size_t max_threads = std::max(4u, std::thread::hardware_concurrency());
+  for (std::size_t amount_threads = 1; amount_threads <= max_threads; amount_threads *= 2) {
+    ThreadPool pool(amount_threads);
+    std::vector<graph_type::context_type> contexts(amount_threads);
+    double pooled_ms = MeasureMs([&]() {
+      pool.RunOnAll([&](std::size_t thread_id) {
+        for (std::size_t i = thread_id; i < sources.size(); i += amount_threads) {
+          graph.DirectionOptimizingBFS(sources[i], contexts[thread_id]);
+        }
+      });
+    }, 1);
+    std::cout << "BFS " << amount_queries << " queries, context per worker, " << amount_threads << " threads: "
+              << pooled_ms << " ms\n";
+  }
+}
+
+template<typename CurGraph>
+class StopAtTargetBFSVisitor : public BFSVisitor<CurGraph> {
+ public:
+  int target = 0;
+  std::size_t amount_discovered = 0;
+
+  bool discover_vertex_BFS(BFSVisitor<CurGraph>::vert_desc top, BFSVisitor<CurGraph>::graph_type &graph) {
+    amount_discovered++;
+    return top == target;
+  }
+};
+
+// Запросы между близкими вершинами большой решетки: обход трогает тысячи вершин из миллионов
+void BenchLocalQueries() {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  std::mt19937 gen(42);
+  const int side = 2000;
+  const int amount_vertex = side * side;
+  const int amount_queries = 2000;
+
+  graph_type graph(amount_vertex);
+  for (int row = 0; row < side; row++) {
+    for (int column = 0; column < side; column++) {
+      int top = row * side + column;
+      if (column + 1 < side) graph.AddEdge(top, top + 1);
+      if (row + 1 < side) graph.AddEdge(top, top + side);
+    }
+  }
+
+  StopAtTargetBFSVisitor<graph_type> visitor;
+  double query_ms = MeasureMs([&]() {
+    std::mt19937 query_gen(7);
+    for (int i = 0; i < amount_queries; i++) {
+      int source = int(query_gen() % (amount_vertex - 30 * side));
+      visitor.target = source + 20 * side + int(query_gen() % 10);
+      graph.BFS(source, visitor);
+    }
+  }, 3);
+  std::cout << "BFS point-to-point on grid V = " << amount_vertex << ", " << amount_queries << " queries: "
+            << query_ms << " ms (" << visitor.amount_discovered / (3 * amount_queries) << " vertices per query)\n";
+}
+
+template<std::size_t Width, typename CurGraph>
+double BenchMultiSourceBFSWidth(CurGraph &graph, const std::vector<int> &sources, long long &checksum) {
+  return MeasureMs([&]() {
+    MultiSourceBFS<CurGraph, Width> engine(graph);
+    for (const auto &statistic : engine.Statistics(sources)) {
+      checksum += statistic.sum_distance;
+    }
+  }, 1);
+}
+
+void BenchMultiSourceBFS() {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  std::mt19937 gen(42);
+  const int amount_vertex = 100000;
+  const int amount_edges = 800000;
+  const int amount_sources = 512;
+
+  graph_type graph(amount_vertex);
+  for (int i = 0; i < amount_edges; i++) {
+    graph.AddEdge(gen() % amount_vertex, gen() % amount_vertex);
+  }
+  std::vector<int> sources(amount_sources);
+  for (int &source : sources) {
+    source = int(gen() % amount_vertex);
+  }
+
+  long long single_checksum = 0;
+  double single_ms = MeasureMs([&]() {
+    for (int source : sources) {
+      DepthBFSVisitor<graph_type> visitor(amount_vertex);
+      visitor.depth[source] = 0;
+      graph.BFS(source, visitor);
+      for (int depth : visitor.depth) {
+        if (depth != INT_MAXIMUS) single_checksum += depth;
+      }
+    }
+  }, 1);
+  long long checksum_64 = 0, checksum_256 = 0, checksum_512 = 0;
+  double ms_64 = BenchMultiSourceBFSWidth<64>(graph, sources, checksum_64);
+  double ms_256 = BenchMultiSourceBFSWidth<256>(graph, sources, checksum_256);
+  double ms_512 = BenchMultiSourceBFSWidth<512>(graph, sources, checksum_512);
+  if (checksum_64 != single_checksum || checksum_256 != single_checksum || checksum_512 != single_checksum) {
+    std::cout << "MS-BFS distances differ\n";
+  }
+  std::cout << "BFS from " << amount_sources << " sources, V = " << amount_vertex << " E = " << amount_edges
+            << ": one by one " << single_ms << " ms, MS-BFS 64 " << ms_64 << " ms, 256 " << ms_256 << " ms, 512 "
+            << ms_512 << " ms\n";
+}
+
+void BenchDejkstra() {
+  using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+  std::mt19937 gen(42);
+
+  auto sparse_graph = MakeRandomWeightedGraph<graph_type>(200000, 800000, 100, gen);
+  std::cout << "Dejkstra sparse V = 200000 E = 800000\n";
+  BenchDejkstraQueues(sparse_graph);
+
+  auto dense_graph = MakeRandomWeightedGraph<graph_type>(3000, 1500000, 100, gen);
+  std::cout << "Dejkstra dense V = 3000 E = 1500000\n";
+  BenchDejkstraQueues(dense_graph);
+}
+
+void BenchDeltaStepping() {
+  using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+  std::mt19937 gen(42);
+
+  auto graph = MakeRandomWeightedGraph<graph_type>(500000, 4000000, 100, gen);
+  DejkstraVisitor<graph_type> visitor(0);
+  double dejkstra_ms = MeasureMs([&]() {
+    graph.Dejkstra(0, visitor);
+  }, 3);
+  std::cout << "DeltaStepping V = 500000 E = 4000000, Dejkstra " << dejkstra_ms << " ms\n";
+
+  std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (std::size_t amount_threads = 1; amount_threads <= max_threads; amount_threads *= 2) {
+    ThreadPool pool(amount_threads);
+    double ms = MeasureMs([&]() {
+      graph.DeltaStepping(0, pool);
+    }, 3);
+    std::cout << "  " << amount_threads << " threads " << ms << " ms\n";
+  }
+}
+
+void BenchBidirectionalDejkstra() {
+  using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+  std::mt19937 gen(42);
+
+  // Решетка похожа на дорожную сеть: малая степень и большой диаметр
+  const int side = 700;
+  graph_type graph(side * side);
+  for (int row = 0; row < side; row++) {
+    for (int col = 0; col < side; col++) {
+      int top = row * side + col;
+      if (col + 1 < side) graph.AddEdge(top, top + 1, 1 + gen() % 100);
+      if (row + 1 < side) graph.AddEdge(top, top + side, 1 + gen() % 100);
+    }
+  }
+
+  const int amount_queries = 20;
+  std::vector<std::pair<int, int>> queries;
+  for (int i = 0; i < amount_queries; i++) {
+    queries.emplace_back(gen() % graph.size(), gen() % graph.size());
+  }
+
+  DejkstraVisitor<graph_type> visitor(0);
+  double dejkstra_ms = MeasureMs([&]() {
+    for (auto [begin, end] : queries) {
+      graph.Dejkstra(begin, visitor);
+    }
+  }, 1);
+  double bidirectional_ms = MeasureMs([&]() {
+    for (auto [begin, end] : queries) {
+      graph.BidirectionalDejkstra(begin, end);
+    }
+  }, 1);
+  std::cout << "s-t queries on grid " << side << "x" << side << " (" << amount_queries << " queries): Dejkstra "
+            << dejkstra_ms << " ms, bidirectional " << bidirectional_ms << " ms\n";
+}
+
+// Прежняя реализация: тройной цикл по std::vector<std::vector<int>> с 0 в роли "нет пути"
+template<typename CurGraph>
+std::vector<std::vector<int>> NaiveFloydWarshall(CurGraph &graph) {
+  std::vector<std::vector<int>> dist = graph.GetMatrixNear();
+  std::size_t amount_vertex = dist.size();
+  for (std::size_t i = 0; i < amount_vertex; i++) {
+    for (std::size_t j = 0; j < amount_vertex; j++) {
+      for (std::size_t k = 0; k < amount_vertex; k++) {
+        if ((dist[j][i] != 0) && (dist[i][k] != 0)) {
+          if ((dist[j][k] == 0) && (j != k)) {
+            dist[j][k] = dist[j][i] + dist[i][k];
+          } else {
+            dist[j][k] = std::min(dist[j][k], dist[j][i] + dist[i][k]);
+          }
+        }
+      }
+    }
+  }
+  return dist;
+}
+
+void BenchMatrixNearTraversal() {
+  using graph_type = Graph<GraphStorageMatrixNear<EdgesWeight_MatrixNear<int>>>;
+  std::mt19937 gen(42);
+  const int amount_vertex = 4096;
+  auto graph = MakeRandomWeightedGraph<graph_type>(amount_vertex, std::size_t(amount_vertex) * 4, 1000, gen);
+
+  BFSVisitor<graph_type> bfs_visitor;
+  double bfs_ms = MeasureMs([&]() { graph.BFS(0, bfs_visitor); }, 3);
+  DejkstraVisitor<graph_type> dejkstra_visitor(0);
+  double dejkstra_ms = MeasureMs([&]() { graph.Dejkstra(0, dejkstra_visitor); }, 3);
+  std::cout << "MatrixNear sparse V = " << amount_vertex << " E = " << amount_vertex * 4 << ": BFS " << bfs_ms
+            << " ms, Dejkstra " << dejkstra_ms << " ms\n";
+}
+
+void BenchMatrixNearLayout() {
+  using storage_type = GraphStorageMatrixNear<EdgesWeight_MatrixNear<int>>;
+  using edges_type = storage_type::edges_type;
+  const int amount_vertex = 4096;
+
+  double add_top_ms = MeasureMs([&]() {
+    storage_type storage(0);
+    for (int top = 0; top < amount_vertex; top++) {
+      std::vector<edges_type> edg(top, edges_type(POISON_VAL_ID_VERT, 0));
+      if (top > 0) edg[top - 1] = edges_type(top - 1, 1);
+      storage.AddTop(std::move(edg));
+    }
+  }, 1);
+
+  std::mt19937 gen(42);
+  using graph_type = Graph<storage_type>;
+  auto graph = MakeRandomWeightedGraph<graph_type>(amount_vertex, std::size_t(amount_vertex) * 64, 1000, gen);
+  long long checksum = 0;
+  double scan_ms = MeasureMs([&]() {
+    auto matrix = graph.GetMatrixNear();
+    for (std::size_t i = 0; i < matrix.size(); i++) {
+      auto row = matrix[i];
+      for (std::size_t j = 0; j < row.size(); j++) {
+        checksum += row[j];
+      }
+    }
+  }, 3);
+  std::cout << "MatrixNear V = " << amount_vertex << ": AddTop one by one " << add_top_ms
+            << " ms, GetMatrixNear full scan " << scan_ms << " ms (checksum " << checksum << ")\n";
+}
+
+void BenchFloydWarshall() {
+  using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+  std::mt19937 gen(42);
+
+  for (int amount_vertex : {1024, 4096}) {
+    auto graph = MakeRandomWeightedGraph<graph_type>(amount_vertex, std::size_t(amount_vertex) * amount_vertex / 4,
+                                                     1000, gen);
+    FloydWarshallVisitor<graph_type> visitor(amount_vertex);
+    double blocked_ms = MeasureMs([&]() {
+      visitor.FloydWarshell(graph);
+    }, 1);
+    std::cout << "FloydWarshall dense V = " << amount_vertex << ": blocked " << blocked_ms << " ms";
+    // Наивный вариант на 4096 вершинах работает минуты, его время оценивается как n^3 от 1024
+    if (amount_vertex <= 1024) {
+      double naive_ms = MeasureMs([&]() {
+        NaiveFloydWarshall(graph);
+      }, 1);
+      std::cout << ", naive " << naive_ms << " ms";
+    }
+    std::cout << "\n";
+  }
+}
+
+void BenchAPSP() {
+  using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+  std::mt19937 gen(42);
+  const int amount_vertex = 2048;
+  std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (int degree : {8, 512}) {
+    auto graph = MakeRandomWeightedGraph<graph_type>(amount_vertex, std::size_t(amount_vertex) * degree, 1000, gen);
+    FloydWarshallVisitor<graph_type> visitor(amount_vertex);
+    std::cout << "APSP V = " << amount_vertex << " E = " << amount_vertex * degree << "\n";
+    for (std::size_t amount_threads = 1; amount_threads <= max_threads; amount_threads *= 2) {
+      ThreadPool pool(amount_threads);
+      double floyd_ms = MeasureMs([&]() {
+        visitor.FloydWarshell(graph, pool, APSPMode::kParallelFloydWarshall);
+      }, 1);
+      double dejkstra_ms = MeasureMs([&]() {
+        visitor.FloydWarshell(graph, pool, APSPMode::kParallelDejkstra);
+      }, 1);
+      visitor.FloydWarshell(graph, pool);
+      std::cout << "  " << amount_threads << " threads: Floyd " << floyd_ms << " ms, V Dejkstras " << dejkstra_ms
+                << " ms, auto picks " << (visitor.GetUsedMode() == APSPMode::kParallelDejkstra ? "Dejkstra" : "Floyd")
+                << "\n";
+    }
+  }
+}
+
+// Двудольная сеть паросочетания: исток -> левая доля -> правая доля -> сток, все пропускные способности 1
+template<typename CurGraph>
+CurGraph MakeUnitCapacityNetwork(int half, int degree, std::mt19937 &gen) {
+  CurGraph graph(2 * half + 2, true);
+  int source = 2 * half, target = 2 * half + 1;
+  for (int i = 0; i < half; i++) {
+    graph.AddEdge(source, i, 1);
+    graph.AddEdge(half + i, target, 1);
+    for (int j = 0; j < degree; j++) {
+      graph.AddEdge(i, half + gen() % half, 1);
+    }
+  }
+  return graph;
+}
+
+// amount_layers слоев по width вершин, ребра только между соседними слоями
+template<typename CurGraph>
+CurGraph MakeLayeredNetwork(int amount_layers, int width, int degree, std::mt19937 &gen) {
+  CurGraph graph(amount_layers * width + 2, true);
+  int source = amount_layers * width, target = amount_layers * width + 1;
+  for (int i = 0; i < width; i++) {
+    graph.AddEdge(source, i, 1000);
+    graph.AddEdge((amount_layers - 1) * width + i, target, 1000);
+  }
+  for (int layer = 0; layer + 1 < amount_layers; layer++) {
+    for (int i = 0; i < width; i++) {
+      for (int j = 0; j < degree; j++) {
+        graph.AddEdge(layer * width + i, (layer + 1) * width + gen() % width, 1 + gen() % 100);
+      }
+    }
+  }
+  return graph;
+}
+
+template<typename CurGraph>
+void BenchMaxFlowOnNetwork(const std::string &name, CurGraph network, bool with_augmenting_paths = true) {
+  using flow_type = typename CurGraph::weight_type;
+  int source = network.size() - 2, target = network.size() - 1;
+  CurGraph graph = network;
+  std::cout << name << "\n";
+
+  auto run = [&](const std::string &algorithm, auto &&max_flow, int repeats) {
+    flow_type flow = 0;
+    double ms = MeasureMs([&]() {
+      graph = network;
+      flow = max_flow(graph);
+    }, repeats);
+    std::cout << "  " << algorithm << ": flow " << flow << ", " << ms << " ms\n";
+  };
+
+  run("push-relabel", [&](CurGraph &cur) {
+    HighestLabelPushRelabel<CurGraph> visitor(source, target, cur.size());
+    return visitor.PushRelabel(source, target, cur);
+  }, 3);
+  run("Dinic", [&](CurGraph &cur) {
+    DFS_BFS_Dinic<CurGraph> visitor(source, target, cur.size());
+    return visitor.Dinic(source, target, cur);
+  }, 3);
+  if (!with_augmenting_paths) return;
+  run("Edmonds-Karp", [&](CurGraph &cur) {
+    BFSAdmondKarp<CurGraph> visitor(source, target, cur.size());
+    return visitor.AdmondKarp(source, target, cur);
+  }, 1);
+  run("Ford-Fulkerson", [&](CurGraph &cur) {
+    DFSFordFulkerson<CurGraph> visitor(source, target, cur.size());
+    return visitor.FordFUlkerson(source, target, cur);
+  }, 1);
+}
+
+void BenchMaxFlow() {
+  using tops_graph = Graph<FlowNetworkStorageTopsEdges<EdgesFlow_TopsEdges<long long>>>;
+  using matrix_graph = Graph<FlowNetworkStorageMatrixNear<EdgesFlow_MatrixNear<long long>>>;
+  std::mt19937 gen(42);
+
+  BenchMaxFlowOnNetwork("MaxFlow unit-capacity bipartite V = 4002",
+                        MakeUnitCapacityNetwork<tops_graph>(2000, 4, gen));
+  BenchMaxFlowOnNetwork("MaxFlow unit-capacity bipartite V = 40002",
+                        MakeUnitCapacityNetwork<tops_graph>(20000, 4, gen), false);
+  BenchMaxFlowOnNetwork("MaxFlow layered 50x40 V = 2002", MakeLayeredNetwork<tops_graph>(50, 40, 4, gen));
+  BenchMaxFlowOnNetwork("MaxFlow layered 50x40 V = 2002 (matrix)",
+                        MakeLayeredNetwork<matrix_graph>(50, 40, 4, gen), false);
+  BenchMaxFlowOnNetwork("MaxFlow unit-capacity bipartite V = 400002",
+                        MakeUnitCapacityNetwork<tops_graph>(200000, 4, gen), false);
+}
+
+template<typename CurGraph>
+CurGraph MakeRandomTree(int amount_vertex, std::mt19937 &gen) {
+  CurGraph graph(amount_vertex);
+  for (int i = 1; i < amount_vertex; i++) {
+    graph.AddEdge(gen() % i, i);
+  }
+  return graph;
+}
+
+void BenchLCA() {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  std::mt19937 gen(42);
+  const int amount_vertex = 1000000;
+  const int amount_queries = 5000000;
+
+  auto graph = MakeRandomTree<graph_type>(amount_vertex, gen);
+  std::vector<std::pair<int, int>> queries(amount_queries);
+  for (auto &query : queries) {
+    query = {int(gen() % amount_vertex), int(gen() % amount_vertex)};
+  }
+  std::vector<int> answers(amount_queries);
+
+  DFSLCAFrakBender<graph_type> visitor(0, amount_vertex);
+  double build_ms = MeasureMs([&]() {
+    visitor = DFSLCAFrakBender<graph_type>(0, amount_vertex);
+    visitor.PreprocessForLCAFrakBender(graph);
+  }, 1);
+  double single_ms = MeasureMs([&]() {
+    for (std::size_t i = 0; i < queries.size(); i++) {
+      answers[i] = visitor.GetLCA(queries[i].first, queries[i].second, graph);
+    }
+  }, 3);
+  double batch_ms = MeasureMs([&]() {
+    visitor.GetLCA(queries, answers);
+  }, 3);
+  std::cout << "LCA Farach-Bender V = " << amount_vertex << ": build " << build_ms << " ms, " << amount_queries
+            << " queries single " << single_ms << " ms, batch " << batch_ms << " ms, memory "
+            << visitor.MemoryUsage() / (1 << 20) << " MB\n";
+
+  DFSLCAFarachColtonBender<graph_type> linear_visitor(0, amount_vertex);
+  double linear_build_ms = MeasureMs([&]() {
+    linear_visitor = DFSLCAFarachColtonBender<graph_type>(0, amount_vertex);
+    linear_visitor.PreprocessForLCA(graph);
+  }, 1);
+  std::vector<int> linear_answers(amount_queries);
+  double linear_ms = MeasureMs([&]() {
+    for (std::size_t i = 0; i < queries.size(); i++) {
+      linear_answers[i] = linear_visitor.GetLCA(queries[i].first, queries[i].second, graph);
+    }
+  }, 3);
+  if (linear_answers != answers) std::cout << "LCA answers differ\n";
+  std::cout << "LCA Farach-Colton-Bender (+-1 RMQ) V = " << amount_vertex << ": build " << linear_build_ms << " ms, "
+            << amount_queries << " queries " << linear_ms << " ms, memory "
+            << linear_visitor.MemoryUsage() / (1 << 20) << " MB\n";
+
+  DFSLCADoubleUp<graph_type> lifting_visitor(0, amount_vertex);
+  double lifting_build_ms = MeasureMs([&]() {
+    lifting_visitor = DFSLCADoubleUp<graph_type>(0, amount_vertex);
+    lifting_visitor.BeReadyForLCA(graph);
+  }, 1);
+  double lifting_ms = MeasureMs([&]() {
+    for (std::size_t i = 0; i < queries.size(); i++) {
+      linear_answers[i] = lifting_visitor.GetLCA(queries[i].first, queries[i].second);
+    }
+  }, 3);
+  if (linear_answers != answers) std::cout << "LCA answers differ\n";
+  std::cout << "LCA binary lifting V = " << amount_vertex << ": " << lifting_visitor.GetAmountLevels()
+            << " levels, build " << lifting_build_ms << " ms, " << amount_queries << " queries " << lifting_ms
+            << " ms\n";
+
+  std::vector<int> distances(amount_queries);
+  double offline_ms = MeasureMs([&]() {
+    DFSLCATarjan<graph_type> offline_visitor(0, amount_vertex);
+    offline_visitor.AnswerQueries(graph, queries, linear_answers, distances);
+  }, 3);
+  if (linear_answers != answers) std::cout << "LCA answers differ\n";
+  std::cout << "LCA offline Tarjan V = " << amount_vertex << ": " << amount_queries << " queries with DFS "
+            << offline_ms << " ms\n";
+}
+
+void BenchHeavyLight() {
+  using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+  std::mt19937 gen(42);
+  const int amount_vertex = 1000000;
+  const int amount_queries = 1000000;
+
+  graph_type graph(amount_vertex);
+  for (int i = 1; i < amount_vertex; i++) {
+    graph.AddEdge(int(gen() % i), i, int(gen() % 1000));
+  }
+  std::vector<std::pair<int, int>> queries(amount_queries);
+  for (auto &query : queries) {
+    query = {int(gen() % amount_vertex), int(gen() % amount_vertex)};
+  }
+
+  DFSHeavyLight<graph_type> visitor(0, amount_vertex);
+  double build_ms = MeasureMs([&]() {
+    visitor = DFSHeavyLight<graph_type>(0, amount_vertex);
+    visitor.BeReadyForPathQueries(graph);
+  }, 1);
+  long long checksum = 0;
+  double query_ms = MeasureMs([&]() {
+    for (auto [u, v] : queries) {
+      auto result = visitor.QueryPath(u, v);
+      checksum += result.sum + result.max - result.min;
+    }
+  }, 3);
+  double update_ms = MeasureMs([&]() {
+    for (int i = 1; i <= amount_queries; i++) {
+      int top = 1 + i % (amount_vertex - 1);
+      visitor.SetEdgeWeight(top, visitor.GetParent(top), i % 1000);
+    }
+  }, 1);
+  std::cout << "Heavy-light V = " << amount_vertex << ": build " << build_ms << " ms, " << amount_queries
+            << " path queries " << query_ms << " ms, " << amount_queries << " updates " << update_ms
+            << " ms (checksum " << checksum << ")\n";
+}
+
+void BenchLCAIndex() {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  std::mt19937 gen(42);
+  const int amount_vertex = 1000000;
+  const int amount_queries = 1000000;
+  const std::string path = "./LCAIndex_bench.bin";
+
+  auto graph = MakeRandomTree<graph_type>(amount_vertex, gen);
+  std::vector<std::pair<int, int>> queries(amount_queries);
+  for (auto &query : queries) {
+    query = {int(gen() % amount_vertex), int(gen() % amount_vertex)};
+  }
+
+  DFSLCAFarachColtonBender<graph_type> visitor(0, amount_vertex);
+  double build_ms = MeasureMs([&]() {
+    visitor = DFSLCAFarachColtonBender<graph_type>(0, amount_vertex);
+    visitor.PreprocessForLCA(graph);
+  }, 1);
+  double save_ms = MeasureMs([&]() { SaveLCAIndex(visitor, path); }, 1);
+  long long checksum = 0;
+  double load_and_query_ms = MeasureMs([&]() {
+    MappedLCAIndex index(path);
+    for (auto [u, v] : queries) {
+      checksum += index.GetLCA(u, v);
+    }
+  }, 1);
+  double verify_ms = MeasureMs([&]() { checksum += MappedLCAIndex(path).VerifyChecksum(); }, 1);
+  std::remove(path.c_str());
+  std::cout << "LCA index V = " << amount_vertex << ": preprocess " << build_ms << " ms, save " << save_ms
+            << " ms, mmap + " << amount_queries << " queries " << load_and_query_ms << " ms, checksum verify "
+            << verify_ms << " ms (" << checksum << ")\n";
+}
+
+int main() {
+  BenchDFS();
+  BenchBFS();
+  BenchTraversalContext();
+  BenchLocalQueries();
+  BenchMultiSourceBFS();
+  BenchDejkstra();
+  BenchDeltaStepping();
+  BenchBidirectionalDejkstra();
+  BenchMatrixNearTraversal();
+  BenchMatrixNearLayout();
+  BenchFloydWarshall();
+  BenchAPSP();
+  BenchMaxFlow();
+  BenchLCA();
+  BenchHeavyLight();
+  BenchLCAIndex();
+}
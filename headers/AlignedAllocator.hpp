@@ -0,0 +1,52 @@
+/**
+ * @file AlignedAllocator.hpp
+ * @brief Аллокатор с выравниванием для плоских матриц, которые обрабатываются векторными инструкциями.
+ */
+
+#ifndef GRAPHALKO_ALIGNEDALLOCATOR_HPP
+#define GRAPHALKO_ALIGNEDALLOCATOR_HPP
+
+#include <new>
+#include <cstddef>
+
+/**
+ * @brief Аллокатор для std::vector, выдающий память, выровненную по Alignment байт.
+ *
+ * По умолчанию выравнивание равно размеру кэш-линии, поэтому строки матрицы с подходящим шагом
+ * начинаются с границы линии и могут читаться выровненными загрузками AVX/SSE.
+ *
+ * @tparam T Тип элементов.
+ * @tparam Alignment Выравнивание в байтах, степень двойки.
+ */
+template<typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+  static_assert((Alignment & (Alignment - 1)) == 0);
+  static_assert(Alignment >= alignof(T));
+ public:
+  using value_type = T;
+
+  template<typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+
+  template<typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+  T *allocate(std::size_t amount) {
+    return static_cast<T *>(::operator new(amount * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  void deallocate(T *ptr, std::size_t) {
+    ::operator delete(ptr, std::align_val_t(Alignment));
+  }
+
+  template<typename U>
+  bool operator==(const AlignedAllocator<U, Alignment> &) const {
+    return true;
+  }
+};
+
+#endif //GRAPHALKO_ALIGNEDALLOCATOR_HPP
@@ -102,6 +102,24 @@ struct EdgesWeight_TopsEdges : public Edges_TopsEdges<T> {
   T weight;
 };
 
+/**
+ * @brief Тип ребра с весом, максимум которого известен во время компиляции.
+ *
+ * Объявленный максимум позволяет Graph::Dejkstra выбрать очередь Диала (см. DejkstraQueueSelector).
+ * Вес ребра не должен его превышать.
+ *
+ * @tparam T Целый тип веса ребра
+ * @tparam MaxWeight Максимальный вес ребра
+ */
+template<typename T, T MaxWeight>
+struct EdgesBoundedWeight_TopsEdges : public EdgesWeight_TopsEdges<T> {
+ public:
+  /// Максимальный вес ребра.
+  static constexpr T max_weight = MaxWeight;
+
+  using EdgesWeight_TopsEdges<T>::EdgesWeight_TopsEdges;
+};
+
 /**
  * @brief Тип ребра для графов представленных списками смежности ребер добавляющий хранения потока
  *
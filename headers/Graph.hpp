@@ -11,8 +11,16 @@
 #include<deque>
 #include<queue>
 #include<cmath>
+#include<bit>
+#include<cstdint>
+#include<atomic>
+#include<utility>
 
 #include "GraphStorage.hpp"
+#include "RingQueue.hpp"
+#include "TraversalContext.hpp"
+#include "PriorityQueues.hpp"
+#include "ThreadPool.hpp"
 /*
 template<typename CurGraphStorage, std::enable_if_t<std::is_base_of_v<GraphStorage<typename CurGraphStorage::edges_type>, CurGraphStorage>, bool> = true>
 class Graph;
@@ -23,8 +31,13 @@ template<typename CurGraphStorage>
 class Graph {
  protected:
   using edge = std::pair<int, int>;
-  std::deque<edge> bfs_deq;
+
   CurGraphStorage storage;
+  /// Входящие ребра для обратных обходов, строятся при первом обращении
+  ReverseAdjacency<typename CurGraphStorage::weight_type> reverse_edges;
+  bool reverse_edges_ready = false;
+  /// Контекст обходов, вызванных без явного контекста; через него работают GetColor, GetDepth и GetPredecessor
+  TraversalContext<CurGraphStorage> default_context;
 
   //GraphStorage storage;
 
@@ -33,6 +46,7 @@ class Graph {
   using edges_type = typename graph_storage::edges_type;
   using weight_type = typename graph_storage::weight_type;
   using iterator = typename graph_storage::iterator;;
+  using context_type = TraversalContext<CurGraphStorage>;
 
   Graph() : storage(0) {
     std::cout << 1;
@@ -41,27 +55,57 @@ class Graph {
   explicit Graph<CurGraphStorage>(std::size_t amount_top, bool orientation = false) : storage(amount_top,
                                                                                               orientation) {}
 
+  explicit Graph<CurGraphStorage>(CurGraphStorage &&ready_storage) : storage(std::move(ready_storage)) {}
+
+  graph_storage &GetStorage() {
+    return storage;
+  }
+
   void PushQeueuBFS(const edge &elem) {
-    bfs_deq.push_back(elem);
+    default_context.bfs_frontier.push_back(elem.second);
   }
 
   weight_type GetWeightFromIter(iterator iter) {
     return storage.GetWeightFromIter(iter);
   }
 
+  iterator BeginEdges(int id) {
+    return storage.BeginEdges(id);
+  }
+
+  iterator EndEdges(int id) {
+    return storage.EndEdges(id);
+  }
+
+  int GetIndexVertex(iterator iter) {
+    return storage.GetIndexVertex(iter);
+  }
+
   int GetDepth(int id) {
-    return storage.GetDepth(id);
+    return default_context.GetDepth(id);
   }
 
   int &GetColor(int id) {
-    return storage.GetColor(id);
+    return default_context.GetColor(id);
   }
 
   weight_type &GetFlow(int from, int to) {
     return storage.GetFlow(from, to);
   }
 
-  std::vector<std::vector<int>> GetMatrixNear() {
+  void Augment(iterator iter, weight_type delta) {
+    storage.Augment(iter, delta);
+  }
+
+  iterator GetReverseEdge(iterator iter) {
+    return storage.GetReverseEdge(iter);
+  }
+
+  /**
+   * Матрица весов: для матрицы смежности - вид на буфер хранилища без копирования (MatrixNearView),
+   * для списков ребер - построенная копия.
+   */
+  auto GetMatrixNear() {
     return storage.GetMatrixNear();
   }
 
@@ -74,25 +118,45 @@ class Graph {
   }
 
   void ConstructPredecessor(int default_color = 0) {
-    storage.ConstructPredecessor(default_color);
+    default_context.ConstructPredecessor(storage.size(), default_color);
   }
 
   void ConstructColor(int default_color = 0) {
-    storage.ConstructColor(default_color);
+    default_context.ConstructColor(storage.size(), default_color);
   }
 
   void ConstructDepth(int default_color = INT_MAXIMUS) {
-    storage.ConstructDepth(default_color);
+    default_context.ConstructDepth(storage.size(), default_color);
   }
 
   int &GetPredecessor(int id) {
-    return storage.GetPredecessor();
+    return default_context.GetPredecessor(id);
+  }
+
+  /**
+   * @brief Контекст, в который пишут обходы без явного контекста.
+   */
+  context_type &GetDefaultContext() {
+    return default_context;
   }
 
   std::size_t size() {
     return storage.size();
   }
 
+  /**
+   * Входящие ребра всех вершин. Строятся один раз и перестраиваются после AddEdge.
+   * Построение меняет граф, поэтому перед параллельными запросами с DirectionOptimizingBFS или
+   * BidirectionalDejkstra по ориентированному графу его нужно вызвать заранее из одного потока.
+   */
+  const ReverseAdjacency<weight_type> &GetReverseEdges() {
+    if (!reverse_edges_ready || reverse_edges.size() != storage.size()) {
+      reverse_edges.Build(storage);
+      reverse_edges_ready = true;
+    }
+    return reverse_edges;
+  }
+
   void PrintGraph() {
     std::cerr << "PrintGraph begin\n";
     storage.PrintStorage();
@@ -105,20 +169,115 @@ class Graph {
 
   void AddEdge(int f, int s, weight_type weight);
 
+  /*
+   * Каждый обход есть в двух видах: без контекста он пишет в default_context (и результат читается через
+   * GetDepth/GetPredecessor графа), с явным контекстом - только в него, не меняя граф. Обходы с разными
+   * контекстами можно запускать одновременно из разных потоков, если посетитель не обращается к состоянию
+   * графа (GetColor, PushQeueuBFS и т.п. работают с default_context) и не разделяется между потоками.
+   */
+
   template<typename CurDFSVisitor>
-  void DFS(int begin_top, CurDFSVisitor &visitor);
+  void DFS(int begin_top, CurDFSVisitor &visitor) {
+    DFS(begin_top, visitor, default_context);
+  }
 
   template<typename CurDFSVisitor>
-  void DFSRecr(int begin_top, CurDFSVisitor &visitor);
+  void DFS(int begin_top, CurDFSVisitor &visitor, context_type &context);
+
+  template<typename CurDFSVisitor>
+  void DFSRecr(int begin_top, CurDFSVisitor &visitor) {
+    DFSRecr(begin_top, visitor, default_context);
+  }
+
+  template<typename CurDFSVisitor>
+  void DFSRecr(int begin_top, CurDFSVisitor &visitor, context_type &context);
+
+  template<typename CurDFSVisitor>
+  void DFSIter(int begin_top, CurDFSVisitor &visitor) {
+    DFSIter(begin_top, visitor, default_context);
+  }
+
+  template<typename CurDFSVisitor>
+  void DFSIter(int begin_top, CurDFSVisitor &visitor, context_type &context);
+
+  template<typename CurBFSVisitor>
+  void BFS(int begin_top, CurBFSVisitor &visitor) {
+    BFS(begin_top, visitor, default_context);
+  }
 
   template<typename CurBFSVisitor>
-  void BFS(int begin_top, CurBFSVisitor &visitor);
+  void BFS(int begin_top, CurBFSVisitor &visitor, context_type &context);
 
   template<typename CurBFSVisitor>
-  void BFSRecr(int begin_top, CurBFSVisitor &visitor);
+  void BFSFrontier(int begin_top, CurBFSVisitor &visitor) {
+    BFSFrontier(begin_top, visitor, default_context);
+  }
+
+  template<typename CurBFSVisitor>
+  void BFSFrontier(int begin_top, CurBFSVisitor &visitor, context_type &context);
+
+  /**
+   * @brief BFS с переключением направления (Beamer и др.): шаги "сверху вниз" по фронту и "снизу вверх" по
+   * непосещенным вершинам, когда фронт велик.
+   *
+   * Пишет глубины и предков в контекст (GetDepth, GetPredecessor); у недостижимых вершин глубина INT_MAXIMUS
+   * и предок POISON_VAL_ID_VERT, у begin_top предок - она сама.
+   *
+   * @param alpha Шаг снизу вверх начинается, когда ребер фронта больше, чем (непроверенных ребер) / alpha.
+   * @param beta Возврат к шагам сверху вниз, когда фронт перестал расти и в нем меньше n / beta вершин.
+   */
+  void DirectionOptimizingBFS(int begin_top, int alpha = 15, int beta = 18) {
+    DirectionOptimizingBFS(begin_top, default_context, alpha, beta);
+  }
+
+  void DirectionOptimizingBFS(int begin_top, context_type &context, int alpha = 15, int beta = 18);
 
+  /**
+   * @brief Параллельный BFS по уровням: фронт уровня делится между потоками пула кусками.
+   *
+   * Вершину захватывает поток, первым сменивший ее цвет 0 -> 1 атомарным compare-exchange; он же пишет глубину
+   * и предка в контекст (как DirectionOptimizingBFS) и кладет вершину в свой локальный буфер, из которых после
+   * барьера собирается следующий фронт.
+   *
+   * Посетитель получает потокобезопасное подмножество хуков BFSVisitor, вызываемых одновременно из разных потоков:
+   * - initialize_vertex_BFS - до обхода, в вызывающем потоке;
+   * - examine_edge_BFS - для каждого ребра из вершины фронта, в любом потоке;
+   * - tree_edge_BFS и затем discover_vertex_BFS - ровно один раз для каждой достигнутой вершины, в захватившем ее
+   *   потоке (для begin_top - только discover_vertex_BFS); если discover_vertex_BFS вернул true, обход
+   *   заканчивается после текущего уровня;
+   * - finish_vertex_BFS - после просмотра всех ребер вершины фронта.
+   * Остальные хуки не вызываются. Хуки для разных вершин идут параллельно, поэтому посетитель может писать только
+   * в данные своей вершины или в атомарные счетчики.
+   */
   template<typename CurBFSVisitor>
-  void Dejkstra(int begin_top, CurBFSVisitor &graph);
+  void ParallelBFS(int begin_top, CurBFSVisitor &visitor, ThreadPool &pool) {
+    ParallelBFS(begin_top, visitor, pool, default_context);
+  }
+
+  template<typename CurBFSVisitor>
+  void ParallelBFS(int begin_top, CurBFSVisitor &visitor, ThreadPool &pool, context_type &context);
+
+  template<typename CurBFSVisitor, typename CurQueue = typename DejkstraQueueSelector<edges_type>::type>
+  void Dejkstra(int begin_top, CurBFSVisitor &visitor) {
+    Dejkstra<CurBFSVisitor, CurQueue>(begin_top, visitor, default_context);
+  }
+
+  template<typename CurBFSVisitor, typename CurQueue = typename DejkstraQueueSelector<edges_type>::type>
+  void Dejkstra(int begin_top, CurBFSVisitor &visitor, context_type &context);
+
+  void DeltaStepping(int begin_top, ThreadPool &pool, int delta = 0) {
+    DeltaStepping(begin_top, pool, default_context, delta);
+  }
+
+  void DeltaStepping(int begin_top, ThreadPool &pool, context_type &context, int delta = 0);
+
+  template<typename CurQueue = typename DejkstraQueueSelector<edges_type>::type>
+  int BidirectionalDejkstra(int begin_top, int end_top, std::vector<int> *path = nullptr) {
+    return BidirectionalDejkstra<CurQueue>(begin_top, end_top, default_context, path);
+  }
+
+  template<typename CurQueue = typename DejkstraQueueSelector<edges_type>::type>
+  int BidirectionalDejkstra(int begin_top, int end_top, context_type &context, std::vector<int> *path = nullptr);
 };
 
 #include "../tpp/Graph.cpp"
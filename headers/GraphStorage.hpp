@@ -13,26 +13,23 @@
 #include <vector>
 #include <iterator>
 #include <deque>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+#include "AlignedAllocator.hpp"
 #include "Edges.hpp"
 #include "iterators.hpp"
 
 /**
  * @brief Базовый класс для хранения данных графа. Его прямое создание может привести к неопределенным результатам
  *
- * Шаблонный класс GraphStorage предоставляет базовые структуры для хранения цвета вершин, глубины и предков.
+ * Хранилище содержит только структуру графа и во время обходов не меняется: цвета, глубины и предки
+ * лежат в TraversalContext.
  *
  * @tparam CurEdges Тип ребра, используемый в графе.
  */
 template<typename CurEdges>
 class GraphStorage {
- protected:
-  /// Цвета вершин
-  std::vector<int> color;
-  /// Глубина вершин
-  std::vector<int> depth;
-  /// Предки для восстановления пути обхода
-  std::vector<int> predecessor;
-
  public:
   /// Тип веса ребра
   using weight_type = typename CurEdges::value_type;
@@ -66,138 +63,6 @@ class GraphStorage {
     throw std::out_of_range(nullptr);
   }
 
-  /**
-   * @brief Возвращает цвет вершины по её идентификатору (константная версия).
-   *
-   * @param id Идентификатор вершины.
-   * @return Цвет вершины.
-   */
-  [[nodiscard]] int GetColor(int id) const {
-    return color[id];
-  }
-
-  /**
-   * @brief Возвращает ссылку на цвет вершины по её идентификатору(для возможности изменения).
-   *
-   * @param id Идентификатор вершины.
-   * @return Ссылка на цвет вершины.
-   */
-  int &GetColor(int id) {
-    return color[id];
-  }
-
-  /**
-   * @brief Очищает массив цветов, чтобы использовалось меньшее количество памяти
-   */
-  void DestructColor() {
-    color.clear();
-  }
-
-  /**
-   * @brief Заполняет массив цветов значениями по умолчанию.
-   *
-   * @param default_color Значение по умолчанию (по умолчанию 0).
-   */
-  void FillColor(int default_color = 0) {
-    while (color.size() != this->size()) {
-      color.push_back(default_color);
-    }
-  }
-
-  /**
-   * @brief Конструирует в случае надобности вектор цветов, заполняя его значениями по умолчанию.
-   *
-   * @param default_color Значение по умолчанию (по умолчанию 0).
-   */
-  void ConstructColor(int default_color = 0) {
-    if (color.size() != this->size()) {
-      DestructColor();
-      FillColor(default_color);
-    } else {
-      for (int &i : color) {
-        i = default_color;
-      }
-    }
-  }
-
-  /**
-   * @brief Возвращает глубину вершины по её идентификатору (константная версия).
-   *
-   * @param id Идентификатор вершины.
-   * @return Глубина вершины.
-   */
-  [[nodiscard]] int GetDepth(int id) const {
-    return depth[id];
-  }
-
-  /**
-   * @brief Возвращает ссылку на глубину вершины по её идентификатору(для возможности изменения).
-   *
-   * @param id Идентификатор вершины.
-   * @return Ссылка на глубину вершины.
-   */
-  int &GetDepth(int id) {
-    return depth[id];
-  }
-
-  /**
-   * @brief Очищает массив цветов, чтобы использовалось меньшее количество памяти
-   */
-  void DestructDepth() {
-    depth.clear();
-  }
-  /**
-   * @brief Заполняет массив глубин значениями по умолчанию.
-   *
-   * @param default_depth Значение по умолчанию (по умолчанию 0).
-   */
-  void FillDepth(int default_depth = INT_MAXIMUS) {
-    while (depth.size() != this->size()) {
-      depth.push_back(default_depth);
-    }
-  }
-
-  /**
-   * @brief Конструирует вектор глубин, заполняя его значениями по умолчанию.
-   *
-   * @param default_depth Значение по умолчанию (по умолчанию INT_MAXIMUS).
-   */
-  void ConstructDepth(int default_depth = INT_MAXIMUS) {
-    if (depth.size() != this->size()) {
-      DestructDepth();
-      FillDepth(default_depth);
-    } else {
-      for (int &i : depth) {
-        i = default_depth;
-      }
-    }
-  }
-
-  [[nodiscard]] int GetPredecessor(int id) const {
-    return predecessor[id];
-  }
-
-  int &GetPredecessor(int id) {
-    return predecessor[id];
-  }
-
-  void DestructPredecessor() {
-    predecessor.clear();
-  }
-
-  void FillPredecessor(int default_value = 0) {
-    while (predecessor.size() != this->size()) {
-      predecessor.push_back(default_value);
-    }
-  }
-
-  void ConstructPredecessor(int default_color = 0) {
-    if (predecessor.size() != this->size()) {
-      DestructPredecessor();
-      FillPredecessor(default_color);
-    }
-  }
-
   /**
    * @brief Возвращает итератор на начало списка ребер по идентификатору вершины.
    *
@@ -286,9 +151,6 @@ class GraphStorageTopsEdges : public GraphStorage<CurEdges> {
   using iterator = NearTopIterator_TopEdges<CurEdges, false>;
   using const_reverse_iterator = std::reverse_iterator<NearTopIterator_TopEdges<CurEdges, true>>;
   using reverse_iterator = std::reverse_iterator<NearTopIterator_TopEdges<CurEdges, false>>;
-  using GraphStorage<CurEdges>::GetColor;
-  using GraphStorage<CurEdges>::GetPredecessor;
-  using GraphStorage<CurEdges>::GetDepth;
 
   /**
    * @brief Конструктор с числом вершин и флагом ориентации.
@@ -361,6 +223,16 @@ class GraphStorageTopsEdges : public GraphStorage<CurEdges> {
     return edges_of_tops.size();
   }
 
+  /**
+   * @brief Возвращает количество ребер, выходящих из вершины.
+   *
+   * @param id Индекс вершины.
+   * @return Степень вершины.
+   */
+  [[nodiscard]] std::size_t Degree(int id) const {
+    return edges_of_tops[id].size();
+  }
+
   /**
    * @brief описание метода см в классе выше
    */
@@ -404,37 +276,194 @@ class GraphStorageTopsEdges : public GraphStorage<CurEdges> {
   }
 
   /**
-   * @brief Возвращает ссылку на цвет вершины в которую идет ребро.
-   *
-   * @param iter Итератор по ребрам.
-   * @return Ссылка на цвет вершины.
+   * @brief Выводит содержимое хранилища графа в std::cerr.
    */
-  int &GetColor(iterator iter) {
-    return this->color[GetIndexVertex(iter)];
+  void PrintStorage() {
+    for (int i = 0; i < edges_of_tops.size(); i++) {
+      std::cerr << i << " : ";
+      for (int j = 0; j < edges_of_tops[i].size(); j++) {
+        std::cerr << edges_of_tops[i][j].where << " ";
+      }
+      std::cerr << "\n";
+    }
   }
+};
+
+/**
+ * @brief Хранение графа в сжатом виде CSR (compressed sparse row), только для чтения.
+ *
+ * Все ребра графа лежат в одном непрерывном массиве, сгруппированные по вершине из которой они выходят,
+ * а массив смещений хранит для каждой вершины начало её списка ребер (offsets[id]..offsets[id + 1]).
+ * Хранилище строится один раз: из GraphStorageTopsEdges или из списка ребер. Добавлять ребра после
+ * построения нельзя. Итераторы те же, что и у GraphStorageTopsEdges, поэтому все Visitor работают без изменений.
+ *
+ * @tparam CurEdges Тип ребра(наследник Edges_TopsEdges).
+ */
+template<typename CurEdges>
+class GraphStorageCSR : public GraphStorage<CurEdges> {
+  static_assert(std::is_base_of_v<Edges_TopsEdges<typename CurEdges::value_type>, CurEdges>);
+ protected:
+  /// Смещения начала списка ребер каждой вершины(размер n + 1)
+  std::vector<std::size_t> offsets;
+  /// Ребра всех вершин подряд
+  std::vector<CurEdges> edges_list;
 
-  int &GetPredecessor(iterator iter) {
-    return this->predecessor[GetIndexVertex(iter)];
+ public:
+  /// Тип ребер
+  using edges_type = CurEdges;
+  /// Тип веса ребра
+  using weight_type = typename edges_type::value_type;
+  /// Итератор для обхода ребер вершины
+  using const_iterator = NearTopIterator_TopEdges<CurEdges, true>;
+  using iterator = NearTopIterator_TopEdges<CurEdges, false>;
+  using const_reverse_iterator = std::reverse_iterator<NearTopIterator_TopEdges<CurEdges, true>>;
+  using reverse_iterator = std::reverse_iterator<NearTopIterator_TopEdges<CurEdges, false>>;
+
+  /**
+   * @brief Конструктор пустого графа с числом вершин и флагом ориентации.
+   *
+   * @param n Число вершин.
+   * @param orientation Флаг ориентации (по умолчанию false).
+   */
+  explicit GraphStorageCSR(std::size_t n, bool orientation = false)
+      : GraphStorage<CurEdges>(n, orientation), offsets(n + 1, 0) {};
+
+  /**
+   * @brief Строит CSR за один проход по спискам смежности GraphStorageTopsEdges.
+   *
+   * Порядок ребер каждой вершины сохраняется.
+   *
+   * @param storage Исходное хранилище.
+   */
+  explicit GraphStorageCSR(GraphStorageTopsEdges<CurEdges> &storage)
+      : GraphStorage<CurEdges>(storage.size(), storage.orientation), offsets(storage.size() + 1, 0) {
+    std::size_t amount_edges = 0;
+    for (std::size_t i = 0; i < storage.size(); i++) {
+      amount_edges += storage.Degree(i);
+    }
+    edges_list.reserve(amount_edges);
+
+    for (std::size_t i = 0; i < storage.size(); i++) {
+      offsets[i] = edges_list.size();
+      for (auto iter = storage.BeginEdges(i); iter != storage.EndEdges(i); ++iter) {
+        edges_list.push_back(*iter);
+      }
+    }
+    offsets[storage.size()] = edges_list.size();
   }
 
   /**
-   * @brief Возвращает ссылку на глубину вершины, в которую идет ребро.
+   * @brief Строит CSR из списка ребер сортировкой подсчетом.
    *
-   * @param iter Итератор по ребрам.
-   * @return Ссылка на глубину вершины.
+   * Для неориентированного графа обратное ребро добавляется сразу за прямым, то есть порядок ребер
+   * совпадает с тем, что дали бы последовательные вызовы GraphStorageTopsEdges::AddEdge.
+   *
+   * @param n Число вершин.
+   * @param edge_list Пары (вершина из которой выходит ребро, ребро).
+   * @param orientation Флаг ориентации (по умолчанию false).
+   */
+  GraphStorageCSR(std::size_t n, const std::vector<std::pair<int, CurEdges>> &edge_list, bool orientation = false)
+      : GraphStorage<CurEdges>(n, orientation), offsets(n + 1, 0) {
+    for (const auto &[from, edge] : edge_list) {
+      offsets[from + 1]++;
+      if (!orientation) offsets[edge.where + 1]++;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+      offsets[i + 1] += offsets[i];
+    }
+    edges_list.resize(offsets[n]);
+
+    std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto &[from, edge] : edge_list) {
+      edges_list[cursor[from]++] = edge;
+      if (!orientation) {
+        CurEdges back_edge = edge;
+        back_edge.where = from;
+        edges_list[cursor[edge.where]++] = back_edge;
+      }
+    }
+  }
+
+  /**
+   * @brief описание метода см в классе выше
    */
-  int &GetDepth(iterator iter) {
-    return this->depth[GetIndexVertex(iter)];
+  iterator BeginEdges(int id) {
+    return iterator(edges_list.begin() + offsets[id]);
   }
 
   /**
-   * @brief Выводит содержимое хранилища графа в std::cerr.
+   * @brief описание метода см в классе выше
+   */
+  iterator EndEdges(int id) {
+    return iterator(edges_list.begin() + offsets[id + 1]);
+  }
+
+  /**
+   * @brief описание метода см в классе выше
+   */
+  [[nodiscard]] virtual std::size_t size() const {
+    return offsets.size() - 1;
+  }
+
+  /**
+   * @brief описание метода см в классе GraphStorageTopsEdges
+   */
+  [[nodiscard]] std::size_t Degree(int id) const {
+    return offsets[id + 1] - offsets[id];
+  }
+
+  /**
+   * @brief описание метода см в классе выше
+   */
+  int GetIndexVertex(iterator iter) {
+    return (*iter).where;
+  }
+
+  /**
+   * @brief описание метода см в классе GraphStorageTopsEdges
+   */
+  weight_type GetWeightFromIter(iterator iter) {
+    if constexpr (std::is_base_of_v<EdgesWeight_TopsEdges<weight_type>, edges_type>)
+      return (*iter).weight;
+    else
+      return 1;
+  }
+
+  /**
+   * @brief описание метода см в классе GraphStorageTopsEdges
+   */
+  weight_type GetWeight(int from, int to) {
+    for (auto iter = BeginEdges(from); iter != EndEdges(from); ++iter) {
+      if ((*iter).where == to)
+        return GetWeightFromIter(iter);
+    }
+    if constexpr (std::is_base_of_v<EdgesWeight_TopsEdges<weight_type>, edges_type>)
+      return weight_type();
+    else
+      return 1;
+  }
+
+  /**
+   * @brief описание метода см в классе GraphStorageTopsEdges
+   */
+  std::vector<std::vector<weight_type>> GetMatrixNear() {
+    std::vector<std::vector<weight_type>> to_ret(size(), std::vector<weight_type>(size(), 0));
+    for (std::size_t i = 0; i < size(); i++) {
+      for (auto iter = BeginEdges(i); iter != EndEdges(i); ++iter) {
+        to_ret[i][(*iter).where] = GetWeightFromIter(iter);
+      }
+    }
+    return to_ret;
+  }
+
+  /**
+   * @brief описание метода см в классе выше
    */
   void PrintStorage() {
-    for (int i = 0; i < edges_of_tops.size(); i++) {
+    for (std::size_t i = 0; i < size(); i++) {
       std::cerr << i << " : ";
-      for (int j = 0; j < edges_of_tops[i].size(); j++) {
-        std::cerr << edges_of_tops[i][j].where << " ";
+      for (std::size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+        std::cerr << edges_list[j].where << " ";
       }
       std::cerr << "\n";
     }
@@ -442,6 +471,101 @@ class GraphStorageTopsEdges : public GraphStorage<CurEdges> {
 };
 
 
+/**
+ * @brief Обратные списки смежности (входящие ребра каждой вершины) в виде CSR.
+ *
+ * Строится одним проходом по любому хранилищу и нужен алгоритмам, которые идут по ребрам в обратную сторону
+ * (обратный поиск двунаправленной Дейкстры, шаг "снизу вверх" в BFS). После изменения графа его нужно построить заново.
+ *
+ * @tparam WeightType Тип веса ребра.
+ */
+template<typename WeightType>
+class ReverseAdjacency {
+ public:
+  /// Входящее ребро: откуда оно идет и его вес
+  struct ReverseEdge {
+    int from;
+    WeightType weight;
+  };
+
+ protected:
+  std::vector<std::size_t> offsets;
+  std::vector<ReverseEdge> edges_list;
+  std::vector<int> out_degree;
+
+ public:
+  /**
+   * @brief Строит обратные списки по хранилищу графа сортировкой подсчетом.
+   *
+   * @param storage Хранилище графа.
+   */
+  template<typename CurGraphStorage>
+  void Build(CurGraphStorage &storage) {
+    std::size_t n = storage.size();
+    offsets.assign(n + 1, 0);
+    out_degree.assign(n, 0);
+    for (std::size_t i = 0; i < n; i++) {
+      for (auto iter = storage.BeginEdges(i); iter != storage.EndEdges(i); ++iter) {
+        offsets[storage.GetIndexVertex(iter) + 1]++;
+        out_degree[i]++;
+      }
+    }
+    for (std::size_t i = 0; i < n; i++) {
+      offsets[i + 1] += offsets[i];
+    }
+    edges_list.resize(offsets[n]);
+
+    std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < n; i++) {
+      for (auto iter = storage.BeginEdges(i); iter != storage.EndEdges(i); ++iter) {
+        edges_list[cursor[storage.GetIndexVertex(iter)]++] = {static_cast<int>(i), storage.GetWeightFromIter(iter)};
+      }
+    }
+  }
+
+  /**
+   * @brief Число вершин, для которых построены списки.
+   */
+  [[nodiscard]] std::size_t size() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+
+  /**
+   * @brief Количество ребер, входящих в вершину.
+   */
+  [[nodiscard]] std::size_t Degree(int id) const {
+    return offsets[id + 1] - offsets[id];
+  }
+
+  /**
+   * @brief Количество ребер, выходящих из вершины (считается при построении заодно).
+   */
+  [[nodiscard]] std::size_t OutDegree(int id) const {
+    return out_degree[id];
+  }
+
+  /**
+   * @brief Общее число ребер графа.
+   */
+  [[nodiscard]] std::size_t AmountEdges() const {
+    return edges_list.size();
+  }
+
+  /**
+   * @brief Начало списка входящих ребер вершины.
+   */
+  [[nodiscard]] const ReverseEdge *BeginEdges(int id) const {
+    return edges_list.data() + offsets[id];
+  }
+
+  /**
+   * @brief Конец списка входящих ребер вершины.
+   */
+  [[nodiscard]] const ReverseEdge *EndEdges(int id) const {
+    return edges_list.data() + offsets[id + 1];
+  }
+};
+
 /**
  * @brief Хранение графа для потоковых графов через список смежных ребер для каждой вершины.
  *
@@ -484,7 +608,6 @@ class FlowNetworkStorageTopsEdges : public GraphStorageTopsEdges<CurEdges> {
    * @throws std::out_of_range Если ребро не найдено.
    */
   base::weight_type &GetFlow(int from, int to) {
-    std::cerr << "GetFlow from = " << from << " to = " << to << "\n";
     for (std::size_t i = 0; i < this->edges_of_tops[from].size(); i++) {
       if (this->edges_of_tops[from][i].where == to)
         return this->edges_of_tops[from][i].flow;
@@ -492,18 +615,42 @@ class FlowNetworkStorageTopsEdges : public GraphStorageTopsEdges<CurEdges> {
     throw(std::out_of_range(nullptr));
   }
 
-/**
- * @brief описание метода см в классе выше
+  /**
+   * @brief Обратное остаточное ребро для ребра iter.
+   *
+   * @param iter Итератор по ребрам.
+   * @return Итератор на ребро из конца iter в его начало, созданное в паре с ним.
    */
+  base::iterator GetReverseEdge(base::iterator iter) {
+    return typename base::iterator(this->edges_of_tops[iter->where].begin() + iter->rev);
+  }
 
+  /**
+   * @brief Пускает delta единиц потока по ребру iter и снимает столько же с парного обратного ребра за O(1).
+   *
+   * @param iter Итератор по ребрам.
+   * @param delta Величина потока.
+   */
+  void Augment(base::iterator iter, base::weight_type delta) {
+    iter->flow += delta;
+    this->edges_of_tops[iter->where][iter->rev].flow -= delta;
+  }
 
+  /**
+   * @brief Добавляет ребро и парное ему обратное остаточное ребро.
+   *
+   * Обратное ребро кладется в список s_top, у него пропускная способность weight для неориентированного графа и 0
+   * для ориентированного. Оба ребра хранят в @c rev индекс друг друга в списке другой вершины.
+   */
   void AddEdge(int f_top, int s_top, base::weight_type weight) {
-    this->edges_of_tops[f_top].push_back(CurEdges(s_top, weight));
-    if (!this->orientation) {
-      this->edges_of_tops[s_top].push_back(CurEdges(f_top, weight));
-    } else {
-      this->edges_of_tops[s_top].push_back(CurEdges(f_top, typename base::weight_type()));
-    }
+    int forward_index = this->edges_of_tops[f_top].size();
+    int backward_index = this->edges_of_tops[s_top].size() + (f_top == s_top ? 1 : 0);
+    CurEdges forward(s_top, weight);
+    forward.rev = backward_index;
+    CurEdges backward(f_top, this->orientation ? typename base::weight_type() : weight);
+    backward.rev = forward_index;
+    this->edges_of_tops[f_top].push_back(forward);
+    this->edges_of_tops[s_top].push_back(backward);
   }
 
   /**
@@ -521,6 +668,64 @@ class FlowNetworkStorageTopsEdges : public GraphStorageTopsEdges<CurEdges> {
   }
 };
 
+/**
+ * @brief Матрица весов GraphStorageMatrixNear без копирования: строки буфера хранилища с шагом stride.
+ *
+ * matrix[i][j] - вес ребра (i, j) или weight_type(), если ребра нет. Вид действителен, пока в хранилище
+ * не добавляются вершины.
+ *
+ * @tparam CurEdges Тип ребра матрицы.
+ */
+template<typename CurEdges>
+class MatrixNearView {
+ public:
+  using weight_type = typename CurEdges::value_type;
+
+  /// Строка матрицы весов
+  class RowView {
+   protected:
+    const CurEdges *row;
+    std::size_t amount;
+
+   public:
+    RowView(const CurEdges *row, std::size_t amount) : row(row), amount(amount) {}
+
+    weight_type operator[](std::size_t j) const {
+      return row[j].weight;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+      return amount;
+    }
+  };
+
+ protected:
+  const CurEdges *data;
+  std::size_t amount;
+  std::size_t stride;
+
+ public:
+  MatrixNearView(const CurEdges *data, std::size_t amount, std::size_t stride)
+      : data(data), amount(amount), stride(stride) {}
+
+  RowView operator[](std::size_t i) const {
+    return RowView(data + i * stride, amount);
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return amount;
+  }
+
+  /// Расстояние между началами соседних строк в ячейках
+  [[nodiscard]] std::size_t Stride() const {
+    return stride;
+  }
+
+  [[nodiscard]] const CurEdges *Data() const {
+    return data;
+  }
+};
+
 /**
  * @brief Хранение графа ввиде матрицы смежности.
  *
@@ -533,9 +738,63 @@ template<typename CurEdges>
 class GraphStorageMatrixNear : public GraphStorage<CurEdges> {
   static_assert(std::is_base_of_v<EdgesWeight_MatrixNear<typename CurEdges::value_type>, CurEdges>);
  protected:
-  /// матрица смежности
-  using edges = std::vector<CurEdges>;
-  std::vector<edges> edges_of_tops;
+  /// Матрица смежности в одном выровненном буфере: ячейка (i, j) лежит в cells[i * stride + j]
+  std::vector<CurEdges, AlignedAllocator<CurEdges>> cells;
+  /// Битовые карты занятых столбцов: бит j строки i установлен, если ребро (i, j) есть
+  std::vector<std::uint64_t, AlignedAllocator<std::uint64_t>> occupancy;
+  std::size_t amount_tops = 0;
+  /// Число строк и столбцов, под которое выделены буферы
+  std::size_t capacity = 0;
+  std::size_t stride = 0;
+  std::size_t occupancy_stride = 0;
+
+  static std::size_t AmountWords(std::size_t n) {
+    return (n + 63) / 64;
+  }
+
+  /// Шаг строки, округленный до целого числа кэш-линий, чтобы каждая строка начиналась с границы 64 байт
+  static std::size_t PaddedStride(std::size_t amount_columns) {
+    constexpr std::size_t kLineElements = 64 / std::gcd<std::size_t>(64, sizeof(CurEdges));
+    return (amount_columns + kLineElements - 1) / kLineElements * kLineElements;
+  }
+
+  /**
+   * @brief Перевыделяет буферы под new_capacity вершин и переносит в них матрицу текущих вершин.
+   *
+   * Новые ячейки заполняются пустым ребром, поэтому AddTop в пределах емкости ничего не перевыделяет.
+   */
+  void Reserve(std::size_t new_capacity) {
+    const std::size_t new_stride = PaddedStride(new_capacity);
+    const std::size_t new_occupancy_stride = (AmountWords(new_capacity) + 7) / 8 * 8;
+    decltype(cells) new_cells(new_capacity * new_stride, CurEdges(POISON_VAL_ID_VERT, typename CurEdges::value_type()));
+    decltype(occupancy) new_occupancy(new_capacity * new_occupancy_stride, 0);
+    for (std::size_t i = 0; i < amount_tops; i++) {
+      std::copy_n(cells.begin() + i * stride, amount_tops, new_cells.begin() + i * new_stride);
+      std::copy_n(occupancy.begin() + i * occupancy_stride, AmountWords(amount_tops),
+                  new_occupancy.begin() + i * new_occupancy_stride);
+    }
+    cells.swap(new_cells);
+    occupancy.swap(new_occupancy);
+    capacity = new_capacity;
+    stride = new_stride;
+    occupancy_stride = new_occupancy_stride;
+  }
+
+  CurEdges &Cell(int from, int to) {
+    return cells[from * stride + to];
+  }
+
+  CurEdges *RowData(int id) {
+    return cells.data() + id * stride;
+  }
+
+  const std::uint64_t *OccupancyRow(int id) const {
+    return occupancy.data() + id * occupancy_stride;
+  }
+
+  void SetOccupied(int from, int to) {
+    occupancy[from * occupancy_stride + (to >> 6)] |= std::uint64_t(1) << (to & 63);
+  }
 
  public:
   /// Тип ребер
@@ -548,45 +807,46 @@ class GraphStorageMatrixNear : public GraphStorage<CurEdges> {
   using iterator = NearTopIterator_NearMatrix<CurEdges, false>;
   using const_reverse_iterator = std::reverse_iterator<NearTopIterator_NearMatrix<CurEdges, true>>;
   using reverse_iterator = std::reverse_iterator<NearTopIterator_NearMatrix<CurEdges, false>>;
-  using GraphStorage<CurEdges>::GetColor;
-  using GraphStorage<CurEdges>::GetPredecessor;
-  using GraphStorage<CurEdges>::GetDepth;
 
   /**
    * @brief Конструктор, создающий матрицу смежности графа.
    *
-   * В конец каждой строки кладем INT_MAXIMUS, чтобы у итераторов по существующим ребрам всегд существовал end()
-   *
-   * А в случае если ребра не существует то инициализирует ребро с помощью глобальной константы POISON_VAL_ID_VERT
+   * Если ребра не существует, ячейка инициализируется ребром в глобальную константу POISON_VAL_ID_VERT
+   * и её бит в occupancy сброшен.
    *
    * @param n Число вершин.
    * @param orientation Флаг ориентации графа (по умолчанию false).
    */
   explicit GraphStorageMatrixNear(std::size_t n, bool orientation = false)
-      : GraphStorage<CurEdges>(n, orientation),
-        edges_of_tops(n, edges(n + 1, edges_type(POISON_VAL_ID_VERT, weight_type()))) {
-    for (std::size_t j = 0; j < n; j++) {
-      edges_of_tops[j][n] = edges_type(INT_MAXIMUS, weight_type());
-    }
+      : GraphStorage<CurEdges>(n, orientation) {
+    Reserve(n);
+    amount_tops = n;
   };
 
-  void AddTop(std::vector<edges> &&edg, std::vector<edges> &&obrat = {}) {
-    if (!this->orientation) {
-      for (auto i = 0; i < edges_of_tops.size(); i++) {
-        edges_of_tops[i].pop_back();
-        edges_of_tops[i].push_back(edg[i]);
-        edges_of_tops[i].push_back(CurEdges(1));
+  /**
+   * @brief Добавляет вершину с номером n (n - текущее число вершин).
+   *
+   * Емкость буфера растет вдвое, поэтому добавление вершины стоит амортизированно O(n).
+   *
+   * @param edg Ребра из новой вершины: edg[i] - ребро в вершину i или ребро с where == POISON_VAL_ID_VERT.
+   * @param obrat Для ориентированного графа ребра в новую вершину: obrat[i] - ребро из вершины i. Для
+   * неориентированного графа ребра в новую вершину зеркальны edg.
+   */
+  void AddTop(std::vector<edges_type> &&edg, std::vector<edges_type> &&obrat = {}) {
+    const std::size_t n = amount_tops;
+    if (n == capacity) Reserve(std::max<std::size_t>(2 * capacity, 8));
+    amount_tops = n + 1;
+    const std::vector<edges_type> &column = this->orientation ? obrat : edg;
+    for (std::size_t i = 0; i < n; i++) {
+      if (column[i].where != POISON_VAL_ID_VERT) {
+        Cell(int(i), int(n)) = column[i];
+        Cell(int(i), int(n)).where = int(n);
+        SetOccupied(int(i), int(n));
       }
-      edg.push_back(1);
-      edges_of_tops.push_back(edg);
-    } else {
-      for (auto i = 0; i < edges_of_tops.size(); i++) {
-        edges_of_tops[i].pop_back();
-        edges_of_tops[i].push_back(obrat[i]);
-        edges_of_tops[i].push_back(1);
+      if (edg[i].where != POISON_VAL_ID_VERT) {
+        Cell(int(n), int(i)) = edg[i];
+        SetOccupied(int(n), int(i));
       }
-      edg.push_back(1);
-      edges_of_tops.push_back(edg);
     }
   }
 
@@ -594,9 +854,11 @@ class GraphStorageMatrixNear : public GraphStorage<CurEdges> {
  * @brief описание метода см в классе выше
    */
   void AddEdge(int f_top, int s_top, weight_type weight = weight_type(1)) {
-    edges_of_tops[f_top][s_top] = edges_type(s_top, weight);
+    Cell(f_top, s_top) = edges_type(s_top, weight);
+    SetOccupied(f_top, s_top);
     if (!this->orientation) {
-      edges_of_tops[s_top][f_top] = edges_type(f_top, weight);
+      Cell(s_top, f_top) = edges_type(f_top, weight);
+      SetOccupied(s_top, f_top);
     }
   }
 
@@ -605,25 +867,32 @@ class GraphStorageMatrixNear : public GraphStorage<CurEdges> {
    */
   template<typename... Args>
   void AddEdge(int f_top, int s_top, Args &&... construct_args) {
-    edges_of_tops[f_top][s_top] = edges_type(s_top, construct_args...);
+    Cell(f_top, s_top) = edges_type(s_top, construct_args...);
+    SetOccupied(f_top, s_top);
     if (!this->orientation) {
-      edges_of_tops[s_top][f_top] = edges_type(f_top, construct_args...);
+      Cell(s_top, f_top) = edges_type(f_top, construct_args...);
+      SetOccupied(s_top, f_top);
     }
   }
 
   /**
    * @brief Возвращает итератор на начало списка ребер для вершины.
    *
-   * Пропускает элементы с POISON_VAL_ID_VERT.(это означает что такого ребра в графе нет)
+   * Первый занятый столбец ищется по битовой карте строки, пустые ячейки (POISON_VAL_ID_VERT) не просматриваются.
    *
    * @param id Индекс вершины.
    * @return Итератор на начало списка ребер.
    */
   iterator BeginEdges(int id) {
-    auto i = edges_of_tops[id].begin();
-    while (i->where == POISON_VAL_ID_VERT)
-      i++; // Пропускаем некорректные элементы
-    return iterator(i);
+    return iterator(RowData(id), OccupancyRow(id), iterator::NextOccupied(OccupancyRow(id), 0, amount_tops),
+                    amount_tops);
+  }
+
+  /**
+   * @brief Есть ли ребро (from, to), за O(1).
+   */
+  [[nodiscard]] bool IsEdge(int from, int to) const {
+    return OccupancyRow(from)[to >> 6] >> (to & 63) & 1;
   }
 
   /**
@@ -645,7 +914,7 @@ class GraphStorageMatrixNear : public GraphStorage<CurEdges> {
    * @brief описание метода см в классе выше
    */
   weight_type GetWeight(int from, int to) {
-    return this->edges_of_tops[from][to].weight;
+    return Cell(from, to).weight;
   }
 
   /**
@@ -655,56 +924,33 @@ class GraphStorageMatrixNear : public GraphStorage<CurEdges> {
    * @return Итератор на конец списка вершин.
    */
   iterator EndEdges(int id) {
-    auto i = edges_of_tops[id].end() - 1;
-    return iterator(i);
+    return iterator(RowData(id), OccupancyRow(id), amount_tops, amount_tops);
   }
 
   /**
-   * @brief Возвращает матрицу смежности, представляющую граф.
+   * @brief Возвращает матрицу весов графа без копирования (см. MatrixNearView).
    *
-   * @return Матрица смежности, где каждый элемент содержит вес соответствующего ребра.
+   * @return Вид на буфер хранилища, где каждый элемент - вес соответствующего ребра.
    */
-  std::vector<std::vector<weight_type>> GetMatrixNear() {
-    std::vector<std::vector<weight_type>> to_ret(edges_of_tops.size(), std::vector<weight_type>(edges_of_tops.size(), 0));
-    for (std::size_t i = 0; i < edges_of_tops.size(); i++) {
-      for (std::size_t j = 0; j < edges_of_tops.size(); j++) {
-        to_ret[i][j] = GetWeightFromIter(iterator(edges_of_tops[i].begin() + j));
-      }
-    }
-    return to_ret;
+  MatrixNearView<CurEdges> GetMatrixNear() const {
+    return MatrixNearView<CurEdges>(cells.data(), amount_tops, stride);
   }
 
   /**
    * @brief описание метода см в классе выше
    */
   virtual std::size_t size() const {
-    return edges_of_tops.size();
+    return amount_tops;
   }
 
-  /**
-   * @brief описание метода см в классе выше
-   */
-  int &GetColor(iterator iter) {
-    return this->color[GetIndexVertex(iter)];
-  }
-  int &GetPredecessor(iterator iter) {
-    return this->predecessor[GetIndexVertex(iter)];
-  }
-
-  /**
-   * @brief описание метода см в классе выше
-   */
-  int &GetDepth(iterator iter) {
-    return this->depth[GetIndexVertex(iter)];
-  }
   /**
    * @brief описание метода см в классе выше
    */
   void PrintStorage() {
-    for (int i = 0; i < edges_of_tops.size(); i++) {
+    for (int i = 0; i < int(amount_tops); i++) {
       std::cerr << i << " : ";
-      for (int j = 0; j < edges_of_tops[i].size(); j++) {
-        std::cerr << edges_of_tops[i][j].weight << "/" << edges_of_tops[i][j].where << "  ";
+      for (int j = 0; j < int(amount_tops); j++) {
+        std::cerr << Cell(i, j).weight << "/" << Cell(i, j).where << "  ";
       }
       std::cerr << "\n";
     }
@@ -746,26 +992,31 @@ class FlowNetworkStorageMatrixNear : public GraphStorageMatrixNear<CurEdges> {
    * @return Ссылка на поток ребра.
    */
   base::weight_type &GetFlow(int from, int to) {
-    return this->edges_of_tops[from][to].flow;
+    return this->Cell(from, to).flow;
   }
 
   /**
    * @brief Добавляет ребро в потоковую сеть представленную в виде матрицы смежности.
    *
    * Если граф неориентированный, добавляется обратное ребро. Для ориентированного графа обратное ребро
-   * добавляется с весом 0.(Так как в алгоритмах с потоками используются обратные ребра)
+   * добавляется с весом 0.(Так как в алгоритмах с потоками используются обратные ребра), если ребра (s_top, f_top)
+   * еще нет. В @c rev обоих ребер записывается столбец парного ребра.
    *
    * @param f_top Индекс исходной вершины.
    * @param s_top Индекс конечной вершины.
    * @param weight Вес ребра (по умолчанию 1).
    */
   void AddEdge(int f_top, int s_top, base::weight_type weight = base::weight_type(1)) {
-    this->edges_of_tops[f_top][s_top] = typename base::edges_type(s_top, weight);
+    this->Cell(f_top, s_top) = typename base::edges_type(s_top, weight);
     if (!this->orientation) {
-      this->edges_of_tops[s_top][f_top] = typename base::edges_type(f_top, weight);
-    } else {
-      this->edges_of_tops[s_top][f_top] = CurEdges(f_top, typename base::weight_type(0));
+      this->Cell(s_top, f_top) = typename base::edges_type(f_top, weight);
+    } else if (this->Cell(s_top, f_top).where == POISON_VAL_ID_VERT) {
+      this->Cell(s_top, f_top) = CurEdges(f_top, typename base::weight_type(0));
     }
+    this->Cell(f_top, s_top).rev = f_top;
+    this->Cell(s_top, f_top).rev = s_top;
+    this->SetOccupied(f_top, s_top);
+    this->SetOccupied(s_top, f_top);
   }
 
   /**
@@ -773,12 +1024,32 @@ class FlowNetworkStorageMatrixNear : public GraphStorageMatrixNear<CurEdges> {
    */
   template<typename... Args>
   void AddEdge(int f_top, int s_top, Args &&... construct_args) {
-    this->edges_of_tops[f_top][s_top] = typename base::edges_type(s_top, construct_args...);
+    this->Cell(f_top, s_top) = typename base::edges_type(s_top, construct_args...);
     if (!this->orientation) {
-      this->edges_of_tops[s_top][f_top] = typename base::edges_type(f_top, construct_args...);
-    } else {
-      this->edges_of_tops[s_top][f_top] = CurEdges(f_top, 0);
+      this->Cell(s_top, f_top) = typename base::edges_type(f_top, construct_args...);
+    } else if (this->Cell(s_top, f_top).where == POISON_VAL_ID_VERT) {
+      this->Cell(s_top, f_top) = CurEdges(f_top, 0);
     }
+    this->Cell(f_top, s_top).rev = f_top;
+    this->Cell(s_top, f_top).rev = s_top;
+    this->SetOccupied(f_top, s_top);
+    this->SetOccupied(s_top, f_top);
+  }
+
+  /**
+   * @brief Обратное остаточное ребро: в матрице это ячейка (to, from), её столбец хранится в @c rev.
+   */
+  base::iterator GetReverseEdge(base::iterator iter) {
+    return typename base::iterator(this->RowData(iter->where), this->OccupancyRow(iter->where), iter->rev,
+                                   this->amount_tops);
+  }
+
+  /**
+   * @brief описание метода см в классе FlowNetworkStorageTopsEdges
+   */
+  void Augment(base::iterator iter, base::weight_type delta) {
+    iter->flow += delta;
+    this->Cell(iter->where, iter->rev).flow -= delta;
   }
 };
 
@@ -0,0 +1,307 @@
+/**
+ * @file PriorityQueues.hpp
+ * @brief Очереди с приоритетом для алгоритма Дейкстры.
+ *
+ * Все очереди имеют одинаковый интерфейс, чтобы их можно было передавать шаблонным параметром в Graph::Dejkstra:
+ * конструктор от числа вершин, @c Push(top, dist) (вставка или уменьшение ключа), @c Top() возвращающий пару
+ * (расстояние, вершина), @c Pop() и @c empty(). Очереди без уменьшения ключа могут возвращать устаревшие пары,
+ * их Dejkstra пропускает, сравнивая расстояние с текущей глубиной вершины.
+ */
+
+#ifndef GRAPHALKO_PRIORITYQUEUES_HPP
+#define GRAPHALKO_PRIORITYQUEUES_HPP
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <type_traits>
+
+/**
+ * @brief Очередь на std::priority_queue с "ленивым" удалением(каждое улучшение расстояния добавляет новую пару).
+ *
+ * Размер очереди ограничен числом ребер, а не вершин.
+ *
+ * @tparam Key Тип расстояния.
+ */
+template<typename Key = int>
+class LazyPriorityQueue {
+ protected:
+  std::priority_queue<std::pair<Key, int>, std::vector<std::pair<Key, int>>, std::greater<>> queue;
+
+ public:
+  using key_type = Key;
+
+  explicit LazyPriorityQueue(std::size_t /*amount_vertex*/) {}
+
+  void Push(int top, Key dist) {
+    queue.emplace(dist, top);
+  }
+
+  [[nodiscard]] std::pair<Key, int> Top() const {
+    return queue.top();
+  }
+
+  void Pop() {
+    queue.pop();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return queue.empty();
+  }
+};
+
+/**
+ * @brief Индексированная d-арная куча с операцией уменьшения ключа.
+ *
+ * Для каждой вершины хранится её позиция в куче, поэтому каждая вершина лежит в куче не больше одного раза
+ * и размер кучи ограничен числом вершин.
+ *
+ * @tparam Arity Число детей у узла кучи.
+ * @tparam Key Тип расстояния.
+ */
+template<std::size_t Arity, typename Key = int>
+class IndexedDaryHeap {
+  static_assert(Arity >= 2);
+ protected:
+  /// Пары (расстояние, вершина)
+  std::vector<std::pair<Key, int>> heap;
+  /// Позиция вершины в heap или -1, если вершины в куче нет
+  std::vector<int> position;
+
+  void Place(std::size_t pos, const std::pair<Key, int> &elem) {
+    heap[pos] = elem;
+    position[elem.second] = pos;
+  }
+
+  void SiftUp(std::size_t pos) {
+    std::pair<Key, int> elem = heap[pos];
+    while (pos > 0) {
+      std::size_t parent = (pos - 1) / Arity;
+      if (!(elem.first < heap[parent].first)) break;
+      Place(pos, heap[parent]);
+      pos = parent;
+    }
+    Place(pos, elem);
+  }
+
+  void SiftDown(std::size_t pos) {
+    std::pair<Key, int> elem = heap[pos];
+    while (true) {
+      std::size_t first_child = pos * Arity + 1;
+      if (first_child >= heap.size()) break;
+      std::size_t last_child = std::min(first_child + Arity, heap.size());
+      std::size_t best = first_child;
+      for (std::size_t child = first_child + 1; child < last_child; child++) {
+        if (heap[child].first < heap[best].first) best = child;
+      }
+      if (!(heap[best].first < elem.first)) break;
+      Place(pos, heap[best]);
+      pos = best;
+    }
+    Place(pos, elem);
+  }
+
+ public:
+  using key_type = Key;
+
+  explicit IndexedDaryHeap(std::size_t amount_vertex) : position(amount_vertex, -1) {}
+
+  /**
+   * @brief Добавляет вершину или уменьшает её ключ, если она уже в куче.
+   */
+  void Push(int top, Key dist) {
+    if (position[top] == -1) {
+      heap.emplace_back(dist, top);
+      SiftUp(heap.size() - 1);
+    } else if (dist < heap[position[top]].first) {
+      heap[position[top]].first = dist;
+      SiftUp(position[top]);
+    }
+  }
+
+  [[nodiscard]] std::pair<Key, int> Top() const {
+    return heap.front();
+  }
+
+  void Pop() {
+    position[heap.front().second] = -1;
+    if (heap.size() > 1) {
+      heap.front() = heap.back();
+      heap.pop_back();
+      SiftDown(0);
+    } else {
+      heap.pop_back();
+    }
+  }
+
+  [[nodiscard]] bool empty() const {
+    return heap.empty();
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return heap.size();
+  }
+};
+
+/**
+ * @brief Монотонная radix-куча для целых неотрицательных расстояний.
+ *
+ * Пара попадает в корзину по номеру старшего бита, в котором её ключ отличается от последнего извлеченного минимума.
+ * При извлечении из пустой нулевой корзины первая непустая корзина перераспределяется по младшим, поэтому каждая пара
+ * переносится не больше числа бит ключа раз. Требует, чтобы добавляемые ключи были не меньше последнего извлеченного
+ * (для алгоритма Дейкстры с неотрицательными весами это так). Уменьшения ключа нет.
+ *
+ * @tparam Key Целый тип расстояния.
+ */
+template<typename Key = int>
+class RadixHeap {
+  static_assert(std::is_integral_v<Key>);
+ protected:
+  using ukey_type = std::make_unsigned_t<Key>;
+  static constexpr std::size_t kAmountBuckets = sizeof(Key) * 8 + 1;
+
+  std::vector<std::pair<Key, int>> buckets[kAmountBuckets];
+  ukey_type last = 0;
+  std::size_t amount = 0;
+
+  std::size_t BucketIndex(Key dist) const {
+    ukey_type key = static_cast<ukey_type>(dist);
+    if (key <= last) return 0;
+    return std::bit_width(static_cast<ukey_type>(key ^ last));
+  }
+
+  void Pull() {
+    if (!buckets[0].empty()) return;
+    std::size_t i = 1;
+    while (buckets[i].empty()) i++;
+
+    ukey_type new_last = static_cast<ukey_type>(buckets[i].front().first);
+    for (const auto &elem : buckets[i]) {
+      new_last = std::min(new_last, static_cast<ukey_type>(elem.first));
+    }
+    last = new_last;
+    for (const auto &elem : buckets[i]) {
+      buckets[BucketIndex(elem.first)].push_back(elem);
+    }
+    buckets[i].clear();
+  }
+
+ public:
+  using key_type = Key;
+
+  explicit RadixHeap(std::size_t /*amount_vertex*/) {}
+
+  void Push(int top, Key dist) {
+    buckets[BucketIndex(dist)].emplace_back(dist, top);
+    amount++;
+  }
+
+  std::pair<Key, int> Top() {
+    Pull();
+    return buckets[0].back();
+  }
+
+  void Pop() {
+    Pull();
+    buckets[0].pop_back();
+    amount--;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return amount == 0;
+  }
+};
+
+/**
+ * @brief Очередь Дейкстры-Диала: циклический массив из MaxWeight + 1 корзин.
+ *
+ * Все расстояния в очереди лежат в отрезке [cur, cur + MaxWeight], поэтому корзина определяется остатком от деления.
+ * Push и Pop работают за O(1) с точностью до пропуска пустых корзин. Вес любого ребра должен быть не больше MaxWeight.
+ * Уменьшения ключа нет.
+ *
+ * @tparam MaxWeight Максимальный вес ребра.
+ * @tparam Key Целый тип расстояния.
+ */
+template<std::size_t MaxWeight, typename Key = int>
+class DialBucketQueue {
+  static_assert(std::is_integral_v<Key>);
+ protected:
+  static constexpr std::size_t kAmountBuckets = MaxWeight + 1;
+
+  /// Корзины в куче, а не в объекте: при MaxWeight = 4096 массив занимал бы на стеке около 100 КБ
+  std::vector<std::vector<int>> buckets;
+  Key cur = 0;
+  std::size_t amount = 0;
+
+  void Advance() {
+    while (buckets[cur % kAmountBuckets].empty()) cur++;
+  }
+
+ public:
+  using key_type = Key;
+
+  explicit DialBucketQueue(std::size_t /*amount_vertex*/) : buckets(kAmountBuckets) {}
+
+  void Push(int top, Key dist) {
+    if (amount == 0 && dist < cur) cur = dist;
+    buckets[dist % kAmountBuckets].push_back(top);
+    amount++;
+  }
+
+  std::pair<Key, int> Top() {
+    Advance();
+    return {cur, buckets[cur % kAmountBuckets].back()};
+  }
+
+  void Pop() {
+    Advance();
+    buckets[cur % kAmountBuckets].pop_back();
+    amount--;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return amount == 0;
+  }
+};
+
+/**
+ * @brief Выбор очереди для Dejkstra по типу ребра во время компиляции.
+ *
+ * - невзвешенные ребра (вес bool) - DialBucketQueue<1>;
+ * - целые веса с объявленным максимумом @c CurEdges::max_weight (см. EdgesBoundedWeight_TopsEdges), если он не больше
+ *   kMaxDialWeight - DialBucketQueue<max_weight>;
+ * - остальные целые веса - RadixHeap;
+ * - нецелые веса - IndexedDaryHeap<4>.
+ *
+ * @tparam CurEdges Тип ребра.
+ */
+template<typename CurEdges>
+struct DejkstraQueueSelector {
+  using weight_type = typename CurEdges::value_type;
+  static constexpr std::size_t kMaxDialWeight = 1 << 12;
+
+  static auto Select() {
+    if constexpr (std::is_same_v<weight_type, bool>) {
+      return DialBucketQueue<1>(0);
+    } else if constexpr (std::is_integral_v<weight_type>) {
+      if constexpr (requires { CurEdges::max_weight; }) {
+        if constexpr (CurEdges::max_weight >= 0 && CurEdges::max_weight <= kMaxDialWeight) {
+          return DialBucketQueue<CurEdges::max_weight>(0);
+        } else {
+          return RadixHeap<>(0);
+        }
+      } else {
+        return RadixHeap<>(0);
+      }
+    } else {
+      return IndexedDaryHeap<4>(0);
+    }
+  }
+
+  using type = decltype(Select());
+};
+
+#endif //GRAPHALKO_PRIORITYQUEUES_HPP
@@ -0,0 +1,85 @@
+/**
+ * @file RingQueue.hpp
+ * @brief Очередь на кольцевом буфере для фронта обхода в ширину.
+ */
+
+#ifndef GRAPHALKO_RINGQUEUE_HPP
+#define GRAPHALKO_RINGQUEUE_HPP
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Очередь FIFO на кольцевом буфере.
+ *
+ * Память выделяется заранее (см. @c Reserve) и переиспользуется между обходами, поэтому
+ * в отличие от std::deque во время обхода нет аллокаций. Если очередь переполняется, буфер
+ * увеличивается вдвое. Емкость всегда степень двойки, чтобы индекс брался по маске.
+ *
+ * @tparam T Тип элементов.
+ */
+template<typename T>
+class RingQueue {
+ protected:
+  std::vector<T> buffer;
+  std::size_t head = 0;
+  std::size_t amount = 0;
+
+  void Grow(std::size_t new_capacity) {
+    std::size_t capacity = 1;
+    while (capacity < new_capacity) capacity <<= 1;
+    std::vector<T> new_buffer(capacity);
+    for (std::size_t i = 0; i < amount; i++) {
+      new_buffer[i] = buffer[(head + i) & (buffer.size() - 1)];
+    }
+    buffer.swap(new_buffer);
+    head = 0;
+  }
+
+ public:
+  RingQueue() = default;
+
+  explicit RingQueue(std::size_t capacity) {
+    Reserve(capacity);
+  }
+
+  /**
+   * @brief Гарантирует, что в очередь поместится capacity элементов без перевыделения.
+   */
+  void Reserve(std::size_t capacity) {
+    if (capacity > buffer.size()) Grow(capacity);
+  }
+
+  void push_back(const T &elem) {
+    if (amount == buffer.size()) Grow(amount * 2 + 1);
+    buffer[(head + amount) & (buffer.size() - 1)] = elem;
+    amount++;
+  }
+
+  T &front() {
+    return buffer[head];
+  }
+
+  void pop_front() {
+    head = (head + 1) & (buffer.size() - 1);
+    amount--;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return amount == 0;
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return amount;
+  }
+
+  /**
+   * @brief Очищает очередь, не освобождая память.
+   */
+  void clear() {
+    head = 0;
+    amount = 0;
+  }
+};
+
+#endif //GRAPHALKO_RINGQUEUE_HPP
@@ -0,0 +1,75 @@
+/**
+ * @file SegmentTree.hpp
+ * @brief Нерекурсивное дерево отрезков для агрегатов на путях дерева.
+ */
+
+#ifndef GRAPHALKO_SEGMENTTREE_HPP
+#define GRAPHALKO_SEGMENTTREE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Дерево отрезков снизу вверх в одном массиве из 2n элементов.
+ *
+ * Листья лежат в nodes[n, 2n), узел i - объединение узлов 2i и 2i+1. Запрос и изменение идут циклом от листьев
+ * к корню без рекурсии, соседние листья и их родители лежат рядом в памяти. Порядок аргументов Combine
+ * сохраняется (левый отрезок - первый аргумент), поэтому операция может быть некоммутативной.
+ *
+ * @tparam T Тип значения.
+ * @tparam Combine Ассоциативная операция T(const T&, const T&).
+ */
+template<typename T, typename Combine>
+class SegmentTree {
+ protected:
+  std::size_t size = 0;
+  std::vector<T> nodes;
+  T identity;
+  Combine combine;
+
+ public:
+  SegmentTree() = default;
+
+  /**
+   * @param leaves Начальные значения листьев.
+   * @param identity Нейтральный элемент операции.
+   */
+  SegmentTree(const std::vector<T> &leaves, T identity, Combine combine = Combine())
+      : size(leaves.size()), nodes(2 * leaves.size(), identity), identity(identity), combine(combine) {
+    std::copy(leaves.begin(), leaves.end(), nodes.begin() + size);
+    for (std::size_t i = size; i-- > 1;) {
+      nodes[i] = this->combine(nodes[2 * i], nodes[2 * i + 1]);
+    }
+  }
+
+  /**
+   * @brief Записывает значение в лист pos и пересчитывает его предков.
+   */
+  void Update(std::size_t pos, const T &value) {
+    pos += size;
+    nodes[pos] = value;
+    for (pos >>= 1; pos > 0; pos >>= 1) {
+      nodes[pos] = combine(nodes[2 * pos], nodes[2 * pos + 1]);
+    }
+  }
+
+  /**
+   * @brief Объединение листьев на полуинтервале [l, r).
+   */
+  T Query(std::size_t l, std::size_t r) const {
+    T left_result = identity;
+    T right_result = identity;
+    for (l += size, r += size; l < r; l >>= 1, r >>= 1) {
+      if (l & 1) left_result = combine(left_result, nodes[l++]);
+      if (r & 1) right_result = combine(nodes[--r], right_result);
+    }
+    return combine(left_result, right_result);
+  }
+
+  const T &Get(std::size_t pos) const {
+    return nodes[pos + size];
+  }
+};
+
+#endif //GRAPHALKO_SEGMENTTREE_HPP
@@ -0,0 +1,130 @@
+/**
+ * @file ThreadPool.hpp
+ * @brief Пул потоков для параллельных алгоритмов на графе.
+ */
+
+#ifndef GRAPHALKO_THREADPOOL_HPP
+#define GRAPHALKO_THREADPOOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Пул из фиксированного числа потоков, выполняющий задачи "фазами".
+ *
+ * Параллельные алгоритмы на графе устроены как последовательность фаз, разделенных барьером
+ * (уровень BFS, корзина delta-stepping, фаза блочного Флойда). @c RunOnAll запускает одну функцию
+ * на всех потоках пула и возвращает управление, когда все они закончили, то есть сам является барьером.
+ * Поток с номером 0 - вызывающий, поэтому пул из одного потока не создает ни одного std::thread.
+ */
+class ThreadPool {
+ protected:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+  const std::function<void(std::size_t)> *task = nullptr;
+  std::size_t generation = 0;
+  std::size_t remaining = 0;
+  bool stop = false;
+
+  void WorkerLoop(std::size_t thread_id) {
+    std::size_t seen_generation = 0;
+    while (true) {
+      const std::function<void(std::size_t)> *cur_task;
+      {
+        std::unique_lock lock(mutex);
+        start_cv.wait(lock, [&]() { return stop || generation != seen_generation; });
+        if (stop) return;
+        seen_generation = generation;
+        cur_task = task;
+      }
+      (*cur_task)(thread_id);
+      {
+        std::lock_guard lock(mutex);
+        if (--remaining == 0) done_cv.notify_one();
+      }
+    }
+  }
+
+ public:
+  /**
+   * @brief Создает пул.
+   *
+   * @param amount_threads Число потоков, включая вызывающий (0 - по числу ядер).
+   */
+  explicit ThreadPool(std::size_t amount_threads = 0) {
+    if (amount_threads == 0) amount_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t i = 1; i < amount_threads; i++) {
+      workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard lock(mutex);
+      stop = true;
+    }
+    start_cv.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief Число потоков пула, включая вызывающий.
+   */
+  [[nodiscard]] std::size_t size() const {
+    return workers.size() + 1;
+  }
+
+  /**
+   * @brief Выполняет func(thread_id) на каждом потоке пула и ждет завершения всех.
+   *
+   * @param func Функция от номера потока в [0, size()).
+   */
+  void RunOnAll(const std::function<void(std::size_t)> &func) {
+    if (workers.empty()) {
+      func(0);
+      return;
+    }
+    {
+      std::lock_guard lock(mutex);
+      task = &func;
+      remaining = workers.size();
+      generation++;
+    }
+    start_cv.notify_all();
+    func(0);
+    std::unique_lock lock(mutex);
+    done_cv.wait(lock, [&]() { return remaining == 0; });
+  }
+
+  /**
+   * @brief Делит отрезок [begin, end) на size() равных кусков и обрабатывает их параллельно.
+   *
+   * @param func Функция func(i, thread_id) для каждого i из отрезка.
+   */
+  template<typename Func>
+  void ParallelFor(std::size_t begin, std::size_t end, Func &&func) {
+    std::size_t amount = end > begin ? end - begin : 0;
+    std::size_t chunk = (amount + size() - 1) / size();
+    RunOnAll([&](std::size_t thread_id) {
+      std::size_t chunk_begin = std::min(end, begin + thread_id * chunk);
+      std::size_t chunk_end = std::min(end, chunk_begin + chunk);
+      for (std::size_t i = chunk_begin; i < chunk_end; i++) {
+        func(i, thread_id);
+      }
+    });
+  }
+};
+
+#endif //GRAPHALKO_THREADPOOL_HPP
@@ -0,0 +1,185 @@
+/**
+ * @file TraversalContext.hpp
+ * @brief Изменяемое состояние одного обхода графа: цвета, глубины, предки и рабочие буферы.
+ */
+
+#ifndef GRAPHALKO_TRAVERSALCONTEXT_HPP
+#define GRAPHALKO_TRAVERSALCONTEXT_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Edges.hpp"
+#include "RingQueue.hpp"
+
+template<typename CurGraphStorage>
+class Graph;
+
+/**
+ * @brief Массив значений вершин со сбросом за O(1).
+ *
+ * Рядом со значением хранится номер эпохи, в которую оно записано. Reset только увеличивает текущую эпоху,
+ * после чего все значения считаются равными значению по умолчанию; ячейка получает его при первом обращении
+ * в новой эпохе. Поэтому запрос, затронувший k вершин, стоит O(k), а не O(n). При переполнении счетчика
+ * эпох метки один раз стираются целиком.
+ *
+ * @tparam T Тип значения.
+ */
+template<typename T>
+class EpochArray {
+ protected:
+  struct Cell {
+    std::uint32_t epoch;
+    T value;
+  };
+
+  std::vector<Cell> cells;
+  std::uint32_t epoch = 0;
+  T default_value{};
+
+ public:
+  /**
+   * @brief Делает все n значений равными value. Память выделяется, только если изменилось n.
+   */
+  void Reset(std::size_t n, T value) {
+    default_value = value;
+    if (cells.size() != n) {
+      cells.assign(n, Cell{0, value});
+      epoch = 0;
+    }
+    if (++epoch == 0) {
+      for (Cell &cell : cells) {
+        cell.epoch = 0;
+      }
+      epoch = 1;
+    }
+  }
+
+  /**
+   * @brief Ссылка на значение; если оно не записано в текущей эпохе, сначала становится значением по умолчанию.
+   */
+  T &operator[](std::size_t id) {
+    Cell &cell = cells[id];
+    if (cell.epoch != epoch) {
+      cell.epoch = epoch;
+      cell.value = default_value;
+    }
+    return cell.value;
+  }
+
+  /// Чтение без записи метки, безопасно при параллельных чтениях
+  T Get(std::size_t id) const {
+    const Cell &cell = cells[id];
+    return cell.epoch == epoch ? cell.value : default_value;
+  }
+
+  /**
+   * @brief Записывает значение по умолчанию во все ячейки прошлых эпох. После этого operator[] ничего
+   * не пишет в метки, и разные потоки могут одновременно обращаться к разным ячейкам.
+   */
+  void Materialize() {
+    for (Cell &cell : cells) {
+      if (cell.epoch != epoch) {
+        cell.epoch = epoch;
+        cell.value = default_value;
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return cells.size();
+  }
+};
+
+/**
+ * @brief Состояние одного запроса к графу, отделенное от хранилища.
+ *
+ * Обходы Graph читают хранилище и пишут только в переданный контекст, поэтому несколько потоков могут
+ * одновременно обходить один граф, если у каждого свой контекст. Цвета, глубины и предки лежат в EpochArray:
+ * сброс в начале обхода стоит O(1), а сам обход - пропорционально числу затронутых вершин. Поэтому контекст
+ * выгодно держать по одному на рабочий поток и переиспользовать между запросами.
+ *
+ * @tparam CurGraphStorage Хранилище графа, итераторы которого попадают в стек DFS.
+ */
+template<typename CurGraphStorage>
+class TraversalContext {
+ protected:
+  friend class Graph<CurGraphStorage>;
+  using storage_iterator = typename CurGraphStorage::iterator;
+
+  /// Кадр явного стека DFS: вершина и текущее ребро в её списке
+  struct DFSFrame {
+    int top;
+    storage_iterator iter;
+    storage_iterator end;
+  };
+
+  /// Цвета вершин
+  EpochArray<int> color;
+  /// Глубина вершин
+  EpochArray<int> depth;
+  /// Предки для восстановления пути обхода
+  EpochArray<int> predecessor;
+
+  RingQueue<int> bfs_frontier;
+  std::vector<DFSFrame> dfs_stack;
+  /// Расстояния и предки обратного поиска двунаправленной Дейкстры
+  EpochArray<int> backward_depth;
+  EpochArray<int> backward_predecessor;
+
+ public:
+  TraversalContext() = default;
+
+  /**
+   * @brief Делает цвета n вершин равными default_color за O(1) (см. EpochArray).
+   */
+  void ConstructColor(std::size_t n, int default_color = 0) {
+    color.Reset(n, default_color);
+  }
+
+  void ConstructDepth(std::size_t n, int default_depth = INT_MAXIMUS) {
+    depth.Reset(n, default_depth);
+  }
+
+  void ConstructPredecessor(std::size_t n, int default_value = 0) {
+    predecessor.Reset(n, default_value);
+  }
+
+  int &GetColor(int id) {
+    return color[id];
+  }
+
+  [[nodiscard]] int GetColor(int id) const {
+    return color.Get(id);
+  }
+
+  int &GetDepth(int id) {
+    return depth[id];
+  }
+
+  [[nodiscard]] int GetDepth(int id) const {
+    return depth.Get(id);
+  }
+
+  int &GetPredecessor(int id) {
+    return predecessor[id];
+  }
+
+  [[nodiscard]] int GetPredecessor(int id) const {
+    return predecessor.Get(id);
+  }
+
+  /// Обратный поиск двунаправленной Дейкстры: расстояние до конечной вершины
+  [[nodiscard]] int GetBackwardDepth(int id) const {
+    return backward_depth.Get(id);
+  }
+
+  /**
+   * @brief Освобождает всю память контекста.
+   */
+  void Destruct() {
+    *this = TraversalContext();
+  }
+};
+
+#endif //GRAPHALKO_TRAVERSALCONTEXT_HPP
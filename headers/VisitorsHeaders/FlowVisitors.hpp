@@ -6,40 +6,58 @@
 #define GRAPHALKO_HEADERS_VISITORSHEADERS_FLOWVISITORS_H_
 #include"Visitors.hpp"
 
+/**
+ * @brief Алгоритм Диница: слоистая сеть через BFS и блокирующий поток с указателями текущей дуги.
+ *
+ * В каждой фазе один Graph::BFS расставляет уровни arr_deep по остаточной сети (останавливаясь на стоке),
+ * затем блокирующий поток ищется итеративным DFS по допустимым ребрам (уровень растет на 1, есть остаточная
+ * пропускная способность). Для каждой вершины хранится текущая дуга current_arc: ребро, с которого продолжается
+ * поиск. Дуга сдвигается только когда ребро насыщено или ведет в тупик, поэтому за фазу каждое ребро просматривается
+ * не больше одного раза, а после увеличения потока путь откатывается лишь до первого насыщенного ребра.
+ */
 template<typename CurGraph>
-class DFS_BFS_Dinic : public DFSVisitor<CurGraph>, public BFSVisitor<CurGraph> {
+class DFS_BFS_Dinic : public BFSVisitor<CurGraph> {
  public:
   using flow_type = typename CurGraph::weight_type;
   using my_type = DFS_BFS_Dinic<CurGraph>;
+  using iterator = typename CurGraph::iterator;
 
  protected:
-  flow_type flow = 0;
   int end;
   int root;
   std::vector<int> arr_deep;
-  std::vector<flow_type> stack_DFS;
+  std::vector<iterator> current_arc;
+  /// Текущий путь от истока: вершины и ребра между ними
+  std::vector<int> path_tops;
+  std::vector<iterator> path_edges;
+
+  bool IsAdmissible(int from, iterator iter, CurGraph &graph) {
+    return arr_deep[graph.GetIndexVertex(iter)] == arr_deep[from] + 1 && (*iter).flow < (*iter).weight;
+  }
+
+  flow_type BlockingFlow(int source, int target, CurGraph &graph);
 
  public:
   DFS_BFS_Dinic(int root, int end, int amount_vertex) : end(end), root(root), arr_deep(amount_vertex, -1) {
     arr_deep[root] = 0;
   }
 
-  void initialize_vertex_BFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+  void initialize_vertex_BFS(BFSVisitor<CurGraph>::vert_desc top, BFSVisitor<CurGraph>::graph_type &graph) {
     graph.GetColor(top) = 1;
     arr_deep[top] = -1;
     if (root == top) arr_deep[top] = 0;
   }
 
-  bool discover_vertex_BFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+  bool discover_vertex_BFS(BFSVisitor<CurGraph>::vert_desc top, BFSVisitor<CurGraph>::graph_type &graph) {
     if (top == end) {
       return true;
     }
     return false;
   }
 
-  void non_tree_edge(DFSVisitor<CurGraph>::edge_desc edge,
-                     DFSVisitor<CurGraph>::edge_desc_iter iter,
-                     DFSVisitor<CurGraph>::graph_type &graph) {
+  void non_tree_edge(BFSVisitor<CurGraph>::edge_desc edge,
+                     BFSVisitor<CurGraph>::edge_desc_iter iter,
+                     BFSVisitor<CurGraph>::graph_type &graph) {
     if ((arr_deep[edge.second] == -1) && ((*iter).flow < (*iter).weight) && (arr_deep[edge.first] != -1)) {
       arr_deep[edge.second] = arr_deep[edge.first] + 1;
       graph.PushQeueuBFS({edge.first, edge.second});
@@ -50,84 +68,75 @@ class DFS_BFS_Dinic : public DFSVisitor<CurGraph>, public BFSVisitor<CurGraph> {
     return arr_deep[target] != -1;
   }
 
-  bool discover_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
-    std::cerr << "discover_vertex_DFS = " << top << " top == end = " << (top == end) << "\n";
-    if (top == end) {
-      return true;
-    }
-    flow = stack_DFS.back();
-    return false;
-  }
-
-  void start_vertex(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
-    flow = flow_type();
-    stack_DFS.clear();
-    stack_DFS.push_back(flow_type(INT_MAXIMUS));
-  }
+  flow_type Dinic(int source, int target, CurGraph &graph);
+};
 
-  void finish_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
-    stack_DFS.push_back(flow_type());
+/*
+ * Блокирующий поток одной фазы. Тупиковая вершина получает уровень -1, чтобы ребра в неё больше не считались
+ * допустимыми, а указатель текущей дуги её предка сдвигается.
+ */
+template<typename CurGraph>
+DFS_BFS_Dinic<CurGraph>::flow_type DFS_BFS_Dinic<CurGraph>::BlockingFlow(int source, int target, CurGraph &graph) {
+  flow_type phase_flow = flow_type();
+  current_arc.clear();
+  for (std::size_t i = 0; i < graph.size(); i++) {
+    current_arc.push_back(graph.BeginEdges(i));
   }
-
-  bool tree_edge_DFS(DFSVisitor<CurGraph>::edge_desc edge,
-                     DFSVisitor<CurGraph>::edge_desc_iter iter,
-                     DFSVisitor<CurGraph>::graph_type &graph) {
-    std::cerr << "find tree edge from = " << edge.first << " to " << edge.second << "   " << arr_deep[edge.first] << "/"
-              << arr_deep[edge.second] << " cur flow = " << (*iter).flow << " cap = " << (*iter).weight << "\n";
-    if ((arr_deep[edge.second] == arr_deep[edge.first] + 1) && ((*iter).flow < (*iter).weight)) {
-      stack_DFS.push_back(std::min(flow, (*iter).weight - (*iter).flow));
-      std::cerr << "stack push " << std::min(flow, (*iter).weight - (*iter).flow) << "\n";
-      return false;
+  path_tops.assign(1, source);
+  path_edges.clear();
+
+  while (!path_tops.empty()) {
+    int top = path_tops.back();
+    if (top == target) {
+      flow_type delta = (*path_edges.front()).weight - (*path_edges.front()).flow;
+      for (auto iter : path_edges) {
+        delta = std::min(delta, (*iter).weight - (*iter).flow);
+      }
+      std::size_t first_saturated = path_edges.size();
+      for (std::size_t i = 0; i < path_edges.size(); i++) {
+        graph.Augment(path_edges[i], delta);
+        if (first_saturated == path_edges.size() && (*path_edges[i]).flow == (*path_edges[i]).weight) {
+          first_saturated = i;
+        }
+      }
+      phase_flow += delta;
+      path_tops.resize(first_saturated + 1);
+      path_edges.erase(path_edges.begin() + first_saturated, path_edges.end());
+      continue;
     }
-    return true;
-  }
 
-  bool finish_edge(DFSVisitor<CurGraph>::edge_desc edge,
-                   DFSVisitor<CurGraph>::edge_desc_iter iter,
-                   DFSVisitor<CurGraph>::graph_type &graph) {
-    flow_type delta = stack_DFS.back();
-    stack_DFS.pop_back();
-    std::cerr << "stack pop " << delta << "\n";
-    flow = stack_DFS.back();
-    stack_DFS.pop_back();
-    std::cerr << "stack pop " << flow << "\n";
-    if (delta > 0) {
-      (*iter).flow += delta;
-      graph.GetFlow(edge.second, edge.first) -= delta;
-      stack_DFS.push_back(delta);
-      std::cerr << "stack push " << delta << "\n";
-      return true;
+    auto &arc = current_arc[top];
+    auto arc_end = graph.EndEdges(top);
+    while (arc != arc_end && !IsAdmissible(top, arc, graph)) {
+      ++arc;
     }
-    stack_DFS.push_back(flow);
-    return false;
+    if (arc == arc_end) {
+      arr_deep[top] = -1;
+      path_tops.pop_back();
+      if (!path_edges.empty()) {
+        path_edges.pop_back();
+        ++current_arc[path_tops.back()];
+      }
+      continue;
+    }
+    path_edges.push_back(arc);
+    path_tops.push_back(graph.GetIndexVertex(arc));
   }
-
-  flow_type Dinic(int source, int target, CurGraph &graph);
-};
+  return phase_flow;
+}
 
 template<typename CurGraph>
 DFS_BFS_Dinic<CurGraph>::flow_type DFS_BFS_Dinic<CurGraph>::Dinic(int source, int target, CurGraph &graph) {
   static_assert((std::is_base_of_v<EdgesFlow_TopsEdges<typename CurGraph::weight_type>, typename CurGraph::edges_type>
       || std::is_base_of_v<EdgesFlow_MatrixNear<typename CurGraph::weight_type>, typename CurGraph::edges_type>));
 
-  std::cerr << "soutce = " << source << " target = " << target << "\n";
-  flow_type max_flow = flow_type(), flow = flow_type();
+  flow_type max_flow = flow_type();
+  if (source == target) return max_flow;
   while (true) {
     graph.template BFS<my_type>(source, *this);
-    std::cerr << "visitor.arr_deep" << "\n";
-    for (int i = 0; i < arr_deep.size(); i++) {
-      std::cerr << i << " : " << arr_deep[i] << "\n";
-    }
     if (!IsTargetAvaliable(target)) break;
-    do {
-      graph.template DFS<my_type>(source, *this);
-      flow = stack_DFS.back();
-      if (flow == flow_type(INT_MAXIMUS)) break;
-      max_flow += flow;
-      stack_DFS.clear();
-    } while (flow != flow_type());
+    max_flow += BlockingFlow(source, target, graph);
   }
-  std::cerr << max_flow;
   return max_flow;
 }
 
@@ -151,7 +160,6 @@ class DFSFordFulkerson : public DFSVisitor<CurGraph> {
   }
 
   bool discover_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
-    std::cerr << "discover_vertex_DFS = " << top << " top == end = " << (top == end) << "\n";
     if (top == end) {
       EndAlgorim = true;
       return true;
@@ -179,7 +187,6 @@ class DFSFordFulkerson : public DFSVisitor<CurGraph> {
     }
     if ((*iter).flow < (*iter).weight) {
       stack_DFS.push_back(std::min(flow, (*iter).weight - (*iter).flow));
-      std::cerr << "stack push " << std::min(flow, (*iter).weight - (*iter).flow) << "\n";
       return false;
     }
     return true;
@@ -190,19 +197,15 @@ class DFSFordFulkerson : public DFSVisitor<CurGraph> {
                    DFSVisitor<CurGraph>::graph_type &graph) {
 
     flow_type delta = stack_DFS.back();
-    std::cerr << "stack pop " << delta << "\n";
     if (!EndAlgorim) {
       stack_DFS.pop_back();
 
       flow = stack_DFS.back();
       stack_DFS.pop_back();
-      std::cerr << "stack pop " << flow << "\n";
     }
     if (delta > 0) {
-      (*iter).flow += delta;
-      graph.GetFlow(edge.second, edge.first) -= delta;
+      graph.Augment(iter, delta);
       stack_DFS.push_back(delta);
-      std::cerr << "stack push " << delta << "\n";
       return true;
     }
     stack_DFS.push_back(flow);
@@ -219,43 +222,49 @@ DFSFordFulkerson<CurGraph>::flow_type DFSFordFulkerson<CurGraph>::FordFUlkerson(
   static_assert((std::is_base_of_v<EdgesFlow_TopsEdges<typename CurGraph::weight_type>, typename CurGraph::edges_type>
       || std::is_base_of_v<EdgesFlow_MatrixNear<typename CurGraph::weight_type>, typename CurGraph::edges_type>));
 
-  std::cerr << "soutce = " << source << " target = " << target << "\n";
   flow_type max_flow = 0, flow = 0;
 
   do {
     graph.template DFS<my_type>(source, *this);
     flow = stack_DFS.back();
     if (!EndAlgorim) break;
-    std::cerr << "flow = " << flow << "\n";
     max_flow += flow;
     stack_DFS.clear();
   } while (true);
 
-  std::cerr << max_flow;
   return max_flow;
 }
 
+/**
+ * @brief Алгоритм Эдмондса-Карпа: увеличение потока вдоль кратчайших по числу ребер путей.
+ *
+ * BFS запоминает для каждой вершины ребро, по которому в неё пришли, поэтому узкое место пути и
+ * увеличение потока (Graph::Augment) считаются за O(1) на ребро без поиска ребер по паре вершин.
+ */
 template<typename CurGraph>
-class BFSAdmondKarp : public DFSVisitor<CurGraph>, public BFSVisitor<CurGraph> {
+class BFSAdmondKarp : public BFSVisitor<CurGraph> {
+ public:
+  using flow_type = typename CurGraph::weight_type;
+  using my_type = BFSAdmondKarp<CurGraph>;
+  using iterator = typename CurGraph::iterator;
+
  protected:
   int end;
   int root;
   bool EndAlgorim;
   std::vector<int> parent;
+  std::vector<iterator> parent_edge;
 
  public:
-  using flow_type = typename CurGraph::weight_type;
-  using my_type = BFSAdmondKarp<CurGraph>;
-
   BFSAdmondKarp(int root, int end, int amount_vertex) : end(end), root(root), parent(amount_vertex, -1) {
   }
 
-  void initialize_vertex_BFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+  void initialize_vertex_BFS(BFSVisitor<CurGraph>::vert_desc top, BFSVisitor<CurGraph>::graph_type &graph) {
     graph.GetColor(top) = 1;
-    parent[top] = -1;
+    parent[top] = top == root ? root : -1;
   }
 
-  bool discover_vertex_BFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+  bool discover_vertex_BFS(BFSVisitor<CurGraph>::vert_desc top, BFSVisitor<CurGraph>::graph_type &graph) {
     if (top == end) {
       EndAlgorim = true;
       return true;
@@ -263,11 +272,12 @@ class BFSAdmondKarp : public DFSVisitor<CurGraph>, public BFSVisitor<CurGraph> {
     return EndAlgorim;
   }
 
-  void non_tree_edge(DFSVisitor<CurGraph>::edge_desc edge,
-                     DFSVisitor<CurGraph>::edge_desc_iter iter,
-                     DFSVisitor<CurGraph>::graph_type &graph) {
+  void non_tree_edge(BFSVisitor<CurGraph>::edge_desc edge,
+                     BFSVisitor<CurGraph>::edge_desc_iter iter,
+                     BFSVisitor<CurGraph>::graph_type &graph) {
     if ((parent[edge.second] == -1) && ((*iter).flow < (*iter).weight)) {
       parent[edge.second] = edge.first;
+      parent_edge[edge.second] = iter;
       graph.PushQeueuBFS({edge.first, edge.second});
     }
   }
@@ -276,39 +286,360 @@ class BFSAdmondKarp : public DFSVisitor<CurGraph>, public BFSVisitor<CurGraph> {
     return parent[target] != -1;
   }
 
-  flow_type AdmondKarp(int source, int target, DFSVisitor<CurGraph>::graph_type &graph);
+  flow_type AdmondKarp(int source, int target, BFSVisitor<CurGraph>::graph_type &graph);
 };
 
 template<typename CurGraph>
 BFSAdmondKarp<CurGraph>::flow_type BFSAdmondKarp<CurGraph>::AdmondKarp(int source,
                                                                        int target,
-                                                                       DFSVisitor<CurGraph>::graph_type &graph) {
+                                                                       BFSVisitor<CurGraph>::graph_type &graph) {
   static_assert((std::is_base_of_v<EdgesFlow_TopsEdges<typename CurGraph::weight_type>, typename CurGraph::edges_type>
       || std::is_base_of_v<EdgesFlow_MatrixNear<typename CurGraph::weight_type>, typename CurGraph::edges_type>));
 
-  std::cerr << "soutce = " << source << " target = " << target << "\n";
-  flow_type max_flow = 0, flow = INT_MAXIMUS;
+  flow_type max_flow = 0;
+  if (source == target) return max_flow;
+  parent_edge.assign(graph.size(), graph.BeginEdges(source));
 
   do {
     EndAlgorim = false;
     graph.template BFS<my_type>(source, *this);
     if (!IsTargetAvaliable(target)) break;
-    for (int i = target; i != source;) {
-      int prev = parent[i];
-      flow = std::min(flow, (graph.GetWeight(prev, i) - graph.GetFlow(prev, i)));
-      i = prev;
+    flow_type flow = (*parent_edge[target]).weight - (*parent_edge[target]).flow;
+    for (int i = target; i != source; i = parent[i]) {
+      flow = std::min(flow, (*parent_edge[i]).weight - (*parent_edge[i]).flow);
     }
-    for (int i = target; i != source;) {
-      int prev = parent[i];
-      graph.GetFlow(prev, i) += flow;
-      graph.GetFlow(i, prev) -= flow;
-      i = prev;
+    for (int i = target; i != source; i = parent[i]) {
+      graph.Augment(parent_edge[i], flow);
     }
-    std::cerr << "flow = " << flow << "\n";
     max_flow += flow;
   } while (true);
 
-  std::cerr << max_flow;
+  return max_flow;
+}
+
+/**
+ * @brief Максимальный поток алгоритмом проталкивания предпотока с выбором вершины наибольшей высоты.
+ *
+ * Первая фаза строит максимальный предпоток: из активных вершин (с избытком) всегда разгружается вершина с
+ * наибольшей высотой, у каждой вершины есть указатель текущей дуги. Две эвристики:
+ * - глобальная перенумерация: высоты пересчитываются обратным BFS от стока по остаточной сети, когда работа на
+ *   подъемы с прошлого пересчета превышает (kGlobalRelabelAlpha * V + E) / 2;
+ * - разрыв: если после подъема на какой-то высоте h < V не осталось вершин, то все вершины выше h отрезаны от
+ *   стока и сразу получают высоту V.
+ * Избыток в стоке после первой фазы и есть величина потока. Вторая фаза возвращает оставшиеся избытки в исток,
+ * чтобы в ребрах графа остался настоящий поток, как после остальных алгоритмов. Минимальный разрез (вершины,
+ * достижимые из истока по остаточной сети) доступен через GetMinCut.
+ */
+template<typename CurGraph>
+class HighestLabelPushRelabel {
+ public:
+  using flow_type = typename CurGraph::weight_type;
+  using iterator = typename CurGraph::iterator;
+
+ protected:
+  /// Стоимость подъема вершины в единицах работы (кроме просмотра её ребер)
+  static constexpr std::size_t kRelabelWork = 12;
+  static constexpr std::size_t kGlobalRelabelAlpha = 6;
+
+  int end;
+  int root;
+  int amount_vertex;
+  std::size_t amount_arcs = 0;
+  std::size_t work_since_relabel = 0;
+
+  std::vector<int> height;
+  std::vector<flow_type> excess;
+  std::vector<iterator> current_arc;
+  /// Стеки активных вершин по высоте, устаревшие записи пропускаются при извлечении
+  std::vector<std::vector<int>> active;
+  int max_active = -1;
+  /// Двусвязные списки всех вершин каждой высоты < V для эвристики разрыва
+  std::vector<int> label_head;
+  std::vector<int> label_next;
+  std::vector<int> label_prev;
+  int max_label = -1;
+
+  RingQueue<int> queue;
+  std::vector<char> source_side;
+
+  static flow_type Residual(iterator iter) {
+    return iter->weight - iter->flow;
+  }
+
+  void LabelInsert(int top) {
+    int label = height[top];
+    label_prev[top] = -1;
+    label_next[top] = label_head[label];
+    if (label_head[label] != -1) label_prev[label_head[label]] = top;
+    label_head[label] = top;
+    max_label = std::max(max_label, label);
+  }
+
+  void LabelRemove(int top) {
+    if (label_prev[top] != -1) {
+      label_next[label_prev[top]] = label_next[top];
+    } else {
+      label_head[height[top]] = label_next[top];
+    }
+    if (label_next[top] != -1) label_prev[label_next[top]] = label_prev[top];
+  }
+
+  void Activate(int top) {
+    active[height[top]].push_back(top);
+    max_active = std::max(max_active, height[top]);
+  }
+
+  void GlobalRelabel(int source, int target, CurGraph &graph);
+  void Gap(int label);
+  void Discharge(int top, int target, CurGraph &graph);
+  void ReturnExcess(int source, int target, CurGraph &graph);
+  void ComputeMinCut(int source, CurGraph &graph);
+
+ public:
+  HighestLabelPushRelabel(int root, int end, int amount_vertex) : end(end), root(root), amount_vertex(amount_vertex) {}
+
+  flow_type PushRelabel(int source, int target, CurGraph &graph);
+
+  /**
+   * @brief Лежит ли вершина в части минимального разреза со стороны истока (после PushRelabel).
+   */
+  bool IsSourceSide(int top) const {
+    return source_side[top];
+  }
+
+  /**
+   * @brief Вершины части минимального разреза со стороны истока (после PushRelabel).
+   */
+  std::vector<int> GetMinCut() const {
+    std::vector<int> to_ret;
+    for (int i = 0; i < amount_vertex; i++) {
+      if (source_side[i]) to_ret.push_back(i);
+    }
+    return to_ret;
+  }
+};
+
+/*
+ * Точные расстояния до стока по остаточной сети: вершина u получает высоту d(v) + 1, если остаточно ребро (u, v),
+ * то есть обратное к ребру из списка v. Недостижимые вершины получают высоту V и в первой фазе больше не участвуют.
+ */
+template<typename CurGraph>
+void HighestLabelPushRelabel<CurGraph>::GlobalRelabel(int source, int target, CurGraph &graph) {
+  std::fill(height.begin(), height.end(), amount_vertex);
+  std::fill(label_head.begin(), label_head.end(), -1);
+  for (int label = 0; label <= max_active; label++) {
+    active[label].clear();
+  }
+  max_active = -1;
+  max_label = -1;
+
+  height[target] = 0;
+  queue.clear();
+  queue.push_back(target);
+  while (!queue.empty()) {
+    int top = queue.front();
+    queue.pop_front();
+    for (auto iter = graph.BeginEdges(top); iter != graph.EndEdges(top); ++iter) {
+      int near = graph.GetIndexVertex(iter);
+      if (height[near] == amount_vertex && near != source && Residual(graph.GetReverseEdge(iter)) > 0) {
+        height[near] = height[top] + 1;
+        queue.push_back(near);
+      }
+    }
+  }
+
+  for (int i = 0; i < amount_vertex; i++) {
+    if (i == source || height[i] == amount_vertex) continue;
+    LabelInsert(i);
+    current_arc[i] = graph.BeginEdges(i);
+    if (excess[i] > 0 && i != target) Activate(i);
+  }
+  work_since_relabel = 0;
+}
+
+template<typename CurGraph>
+void HighestLabelPushRelabel<CurGraph>::Gap(int label) {
+  for (int cur = label + 1; cur <= max_label; cur++) {
+    for (int top = label_head[cur]; top != -1; top = label_next[top]) {
+      height[top] = amount_vertex;
+    }
+    label_head[cur] = -1;
+  }
+  max_label = label - 1;
+}
+
+template<typename CurGraph>
+void HighestLabelPushRelabel<CurGraph>::Discharge(int top, int target, CurGraph &graph) {
+  while (excess[top] > 0) {
+    auto &arc = current_arc[top];
+    auto arc_end = graph.EndEdges(top);
+    for (; arc != arc_end; ++arc) {
+      if (Residual(arc) <= 0) continue;
+      int near = graph.GetIndexVertex(arc);
+      if (height[top] != height[near] + 1) continue;
+      flow_type delta = std::min(excess[top], Residual(arc));
+      graph.Augment(arc, delta);
+      excess[top] -= delta;
+      if (excess[near] == 0 && near != target) {
+        excess[near] += delta;
+        Activate(near);
+      } else {
+        excess[near] += delta;
+      }
+      if (excess[top] == 0) break;
+    }
+    if (excess[top] == 0) break;
+
+    int old_label = height[top];
+    LabelRemove(top);
+    if (label_head[old_label] == -1) {
+      Gap(old_label);
+      height[top] = amount_vertex;
+      return;
+    }
+    int new_label = amount_vertex;
+    for (auto iter = graph.BeginEdges(top); iter != graph.EndEdges(top); ++iter) {
+      work_since_relabel++;
+      if (Residual(iter) > 0) new_label = std::min(new_label, height[graph.GetIndexVertex(iter)] + 1);
+    }
+    work_since_relabel += kRelabelWork;
+    current_arc[top] = graph.BeginEdges(top);
+    height[top] = std::min(new_label, amount_vertex);
+    if (height[top] == amount_vertex) return;
+    LabelInsert(top);
+  }
+}
+
+/*
+ * Вторая фаза: избыток вершин, отрезанных от стока, возвращается в исток обычным проталкиванием в порядке FIFO.
+ * Начальные высоты - V плюс расстояние до истока по остаточной сети, поэтому они корректны.
+ */
+template<typename CurGraph>
+void HighestLabelPushRelabel<CurGraph>::ReturnExcess(int source, int target, CurGraph &graph) {
+  const int unreachable = 2 * amount_vertex;
+  std::fill(height.begin(), height.end(), unreachable);
+  height[source] = amount_vertex;
+  height[target] = unreachable;
+  queue.clear();
+  queue.push_back(source);
+  while (!queue.empty()) {
+    int top = queue.front();
+    queue.pop_front();
+    for (auto iter = graph.BeginEdges(top); iter != graph.EndEdges(top); ++iter) {
+      int near = graph.GetIndexVertex(iter);
+      if (height[near] == unreachable && near != target && Residual(graph.GetReverseEdge(iter)) > 0) {
+        height[near] = height[top] + 1;
+        queue.push_back(near);
+      }
+    }
+  }
+
+  for (int i = 0; i < amount_vertex; i++) {
+    current_arc[i] = graph.BeginEdges(i);
+    if (i != source && i != target && excess[i] > 0) queue.push_back(i);
+  }
+  while (!queue.empty()) {
+    int top = queue.front();
+    queue.pop_front();
+    while (excess[top] > 0) {
+      auto &arc = current_arc[top];
+      auto arc_end = graph.EndEdges(top);
+      for (; arc != arc_end; ++arc) {
+        if (Residual(arc) <= 0) continue;
+        int near = graph.GetIndexVertex(arc);
+        if (height[top] != height[near] + 1) continue;
+        flow_type delta = std::min(excess[top], Residual(arc));
+        graph.Augment(arc, delta);
+        excess[top] -= delta;
+        if (excess[near] == 0 && near != source && near != target) queue.push_back(near);
+        excess[near] += delta;
+        if (excess[top] == 0) break;
+      }
+      if (excess[top] == 0) break;
+      int new_label = unreachable;
+      for (auto iter = graph.BeginEdges(top); iter != graph.EndEdges(top); ++iter) {
+        if (Residual(iter) > 0) new_label = std::min(new_label, height[graph.GetIndexVertex(iter)] + 1);
+      }
+      height[top] = new_label;
+      current_arc[top] = graph.BeginEdges(top);
+    }
+  }
+}
+
+template<typename CurGraph>
+void HighestLabelPushRelabel<CurGraph>::ComputeMinCut(int source, CurGraph &graph) {
+  source_side.assign(amount_vertex, 0);
+  source_side[source] = 1;
+  queue.clear();
+  queue.push_back(source);
+  while (!queue.empty()) {
+    int top = queue.front();
+    queue.pop_front();
+    for (auto iter = graph.BeginEdges(top); iter != graph.EndEdges(top); ++iter) {
+      int near = graph.GetIndexVertex(iter);
+      if (!source_side[near] && Residual(iter) > 0) {
+        source_side[near] = 1;
+        queue.push_back(near);
+      }
+    }
+  }
+}
+
+template<typename CurGraph>
+HighestLabelPushRelabel<CurGraph>::flow_type HighestLabelPushRelabel<CurGraph>::PushRelabel(int source,
+                                                                                         int target,
+                                                                                         CurGraph &graph) {
+  static_assert((std::is_base_of_v<EdgesFlow_TopsEdges<typename CurGraph::weight_type>, typename CurGraph::edges_type>
+      || std::is_base_of_v<EdgesFlow_MatrixNear<typename CurGraph::weight_type>, typename CurGraph::edges_type>));
+
+  height.assign(amount_vertex, 0);
+  excess.assign(amount_vertex, flow_type());
+  current_arc.assign(amount_vertex, graph.BeginEdges(source));
+  active.assign(amount_vertex, {});
+  label_head.assign(amount_vertex, -1);
+  label_next.assign(amount_vertex, -1);
+  label_prev.assign(amount_vertex, -1);
+  queue.Reserve(amount_vertex);
+  max_active = -1;
+  max_label = -1;
+  if (source == target) {
+    ComputeMinCut(source, graph);
+    return flow_type();
+  }
+
+  amount_arcs = 0;
+  for (int i = 0; i < amount_vertex; i++) {
+    for (auto iter = graph.BeginEdges(i); iter != graph.EndEdges(i); ++iter) {
+      amount_arcs++;
+    }
+  }
+  for (auto iter = graph.BeginEdges(source); iter != graph.EndEdges(source); ++iter) {
+    flow_type delta = Residual(iter);
+    int near = graph.GetIndexVertex(iter);
+    if (delta <= 0 || near == source) continue;
+    graph.Augment(iter, delta);
+    excess[near] += delta;
+    excess[source] -= delta;
+  }
+
+  GlobalRelabel(source, target, graph);
+  while (max_active >= 0) {
+    if (active[max_active].empty()) {
+      max_active--;
+      continue;
+    }
+    int top = active[max_active].back();
+    active[max_active].pop_back();
+    if (height[top] != max_active || excess[top] <= 0) continue;
+    Discharge(top, target, graph);
+    if (2 * work_since_relabel > kGlobalRelabelAlpha * amount_vertex + amount_arcs) {
+      GlobalRelabel(source, target, graph);
+    }
+  }
+
+  flow_type max_flow = excess[target];
+  ReturnExcess(source, target, graph);
+  ComputeMinCut(source, graph);
   return max_flow;
 }
 
@@ -0,0 +1,234 @@
+/**
+ * @file LCAIndex.hpp
+ * @brief Сохранение предобработанного LCA (схема Фарах-Колтона и Бендера) в файл и загрузка через mmap.
+ *
+ * Файл: заголовок LCAIndexHeader, затем секции first, euler, block_mask, block_table, in_block, каждая с границы
+ * 64 байт. Смещения секций однозначно задаются размерами из заголовка. Данные пишутся в порядке байт машины,
+ * чужой порядок байт отсекается проверкой версии.
+ */
+
+#ifndef GRAPHALKO_HEADERS_VISITORSHEADERS_LCAINDEX_HPP_
+#define GRAPHALKO_HEADERS_VISITORSHEADERS_LCAINDEX_HPP_
+
+#include "LCAVisitors.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Заголовок файла индекса LCA
+struct LCAIndexHeader {
+  static constexpr char kMagic[8] = {'G', 'R', 'L', 'C', 'A', 'I', 'D', 'X'};
+  static constexpr std::uint32_t kVersion = 1;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t block_size;
+  std::uint64_t amount_vertex;
+  std::uint64_t euler_size;
+  std::uint64_t amount_blocks;
+  std::uint64_t amount_levels;
+  std::uint64_t in_block_size;
+  /// FNV-1a по всем байтам после заголовка
+  std::uint64_t checksum;
+};
+static_assert(sizeof(LCAIndexHeader) == 64);
+
+/// Смещения секций файла индекса в байтах
+struct LCAIndexLayout {
+  static constexpr std::size_t kAlignment = 64;
+
+  std::size_t first = 0;
+  std::size_t euler = 0;
+  std::size_t block_mask = 0;
+  std::size_t block_table = 0;
+  std::size_t in_block = 0;
+  std::size_t total = 0;
+
+  static std::size_t Align(std::size_t offset) {
+    return (offset + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  explicit LCAIndexLayout(const LCAIndexHeader &header) {
+    using DepthVertex = FarachColtonBenderView::DepthVertex;
+    first = sizeof(LCAIndexHeader);
+    euler = Align(first + header.amount_vertex * sizeof(int));
+    block_mask = Align(euler + header.euler_size * sizeof(DepthVertex));
+    block_table = Align(block_mask + header.amount_blocks * sizeof(FarachColtonBenderView::mask_type));
+    in_block = Align(block_table + header.amount_levels * header.amount_blocks * sizeof(DepthVertex));
+    total = in_block + header.in_block_size;
+  }
+};
+
+/// 64-битный FNV-1a, продолжающий хеш hash
+inline std::uint64_t FNV1a(const void *data, std::size_t size, std::uint64_t hash = 14695981039346656037ull) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Записывает построенный индекс в файл.
+ *
+ * @throws std::runtime_error Если файл не удалось записать.
+ */
+inline void SaveLCAIndex(const FarachColtonBenderView &view, const std::string &path) {
+  LCAIndexHeader header{};
+  std::memcpy(header.magic, LCAIndexHeader::kMagic, sizeof(header.magic));
+  header.version = LCAIndexHeader::kVersion;
+  header.block_size = view.block_size;
+  header.amount_vertex = view.amount_vertex;
+  header.euler_size = view.euler_size;
+  header.amount_blocks = view.amount_blocks;
+  header.amount_levels = view.AmountLevels();
+  header.in_block_size = view.InBlockTableSize();
+  LCAIndexLayout layout(header);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) throw std::runtime_error("LCA index: cannot open " + path);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  std::size_t offset = sizeof(header);
+  std::uint64_t checksum = FNV1a(nullptr, 0);
+  auto write_section = [&](std::size_t section_offset, const void *data, std::size_t size) {
+    static constexpr char kPadding[LCAIndexLayout::kAlignment] = {};
+    checksum = FNV1a(kPadding, section_offset - offset, checksum);
+    file.write(kPadding, std::streamsize(section_offset - offset));
+    checksum = FNV1a(data, size, checksum);
+    file.write(static_cast<const char *>(data), std::streamsize(size));
+    offset = section_offset + size;
+  };
+  write_section(layout.first, view.first, header.amount_vertex * sizeof(int));
+  write_section(layout.euler, view.euler, header.euler_size * sizeof(FarachColtonBenderView::DepthVertex));
+  write_section(layout.block_mask, view.block_mask,
+                header.amount_blocks * sizeof(FarachColtonBenderView::mask_type));
+  write_section(layout.block_table, view.block_table,
+                header.amount_levels * header.amount_blocks * sizeof(FarachColtonBenderView::DepthVertex));
+  write_section(layout.in_block, view.in_block, header.in_block_size);
+
+  header.checksum = checksum;
+  file.seekp(0);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  if (!file) throw std::runtime_error("LCA index: write failed for " + path);
+}
+
+template<typename CurGraph>
+void SaveLCAIndex(const DFSLCAFarachColtonBender<CurGraph> &visitor, const std::string &path) {
+  SaveLCAIndex(visitor.GetView(), path);
+}
+
+/**
+ * @brief Индекс LCA, отображенный из файла в память только для чтения.
+ *
+ * Запросы идут прямо по страницам файла без копирования и без DFS. Страницы подгружаются по мере обращений,
+ * доступ помечается случайным (MADV_RANDOM), чтобы ядро не читало наперед. При открытии проверяются заголовок
+ * и размер файла. Контрольная сумма проверяется отдельно через VerifyChecksum, так как она читает весь файл.
+ */
+class MappedLCAIndex {
+ protected:
+  void *data = nullptr;
+  std::size_t size = 0;
+  FarachColtonBenderView view;
+
+  void Unmap() {
+    if (data != nullptr) munmap(data, size);
+    data = nullptr;
+    size = 0;
+  }
+
+ public:
+  /**
+   * @throws std::runtime_error Если файл не открывается или не является индексом этой версии.
+   */
+  explicit MappedLCAIndex(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) throw std::runtime_error("LCA index: cannot open " + path);
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) == -1 || std::size_t(file_stat.st_size) < sizeof(LCAIndexHeader)) {
+      close(fd);
+      throw std::runtime_error("LCA index: truncated file " + path);
+    }
+    size = file_stat.st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      data = nullptr;
+      throw std::runtime_error("LCA index: mmap failed for " + path);
+    }
+    madvise(data, size, MADV_RANDOM);
+
+    const LCAIndexHeader &header = Header();
+    view.amount_vertex = header.amount_vertex;
+    view.euler_size = header.euler_size;
+    view.amount_blocks = header.amount_blocks;
+    view.block_size = int(header.block_size);
+    // Размеры должны согласовываться друг с другом, иначе запрос может выйти за границы отображения
+    bool consistent = header.block_size >= 1 && header.block_size <= 16
+        && header.amount_blocks == (header.euler_size + header.block_size - 1) / header.block_size
+        && header.amount_levels == view.AmountLevels() && header.in_block_size == view.InBlockTableSize();
+    if (std::memcmp(header.magic, LCAIndexHeader::kMagic, sizeof(header.magic)) != 0
+        || header.version != LCAIndexHeader::kVersion || !consistent || LCAIndexLayout(header).total != size) {
+      Unmap();
+      throw std::runtime_error("LCA index: bad header in " + path);
+    }
+    LCAIndexLayout layout(header);
+    const char *bytes = static_cast<const char *>(data);
+    view.first = reinterpret_cast<const int *>(bytes + layout.first);
+    view.euler = reinterpret_cast<const FarachColtonBenderView::DepthVertex *>(bytes + layout.euler);
+    view.block_mask = reinterpret_cast<const FarachColtonBenderView::mask_type *>(bytes + layout.block_mask);
+    view.block_table = reinterpret_cast<const FarachColtonBenderView::DepthVertex *>(bytes + layout.block_table);
+    view.in_block = reinterpret_cast<const std::uint8_t *>(bytes + layout.in_block);
+  }
+
+  MappedLCAIndex(const MappedLCAIndex &) = delete;
+  MappedLCAIndex &operator=(const MappedLCAIndex &) = delete;
+
+  MappedLCAIndex(MappedLCAIndex &&other) noexcept
+      : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), view(other.view) {}
+
+  MappedLCAIndex &operator=(MappedLCAIndex &&other) noexcept {
+    if (this != &other) {
+      Unmap();
+      data = std::exchange(other.data, nullptr);
+      size = std::exchange(other.size, 0);
+      view = other.view;
+    }
+    return *this;
+  }
+
+  ~MappedLCAIndex() {
+    Unmap();
+  }
+
+  [[nodiscard]] const LCAIndexHeader &Header() const {
+    return *static_cast<const LCAIndexHeader *>(data);
+  }
+
+  /**
+   * @brief Пересчитывает FNV-1a по всему файлу и сравнивает с заголовком (читает все страницы).
+   */
+  [[nodiscard]] bool VerifyChecksum() const {
+    const char *bytes = static_cast<const char *>(data);
+    return FNV1a(bytes + sizeof(LCAIndexHeader), size - sizeof(LCAIndexHeader)) == Header().checksum;
+  }
+
+  [[nodiscard]] const FarachColtonBenderView &GetView() const {
+    return view;
+  }
+
+  [[nodiscard]] int GetLCA(int u, int v) const {
+    return view.GetLCA(u, v);
+  }
+};
+
+#endif //GRAPHALKO_HEADERS_VISITORSHEADERS_LCAINDEX_HPP_
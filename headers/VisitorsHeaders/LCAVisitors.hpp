@@ -6,7 +6,23 @@
 #define GRAPHALKO_HEADERS_VISITORSHEADERS_LCAVISITORS_HPP_
 
 #include"Visitors.hpp"
-
+#include "SegmentTree.hpp"
+
+#include <span>
+#include <bit>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+/**
+ * @brief LCA и взвешенное расстояние двоичными подъемами.
+ *
+ * Предки хранятся одним массивом по уровням: ancestors[level * n + v] - предок v на 2^level ребер выше (корень -
+ * сам себе предок). Число уровней берется по реальной глубине дерева, найденной в DFS, поэтому для неглубоких
+ * деревьев таблица и число шагов запроса малы. Времена входа/выхода и взвешенная глубина вершины лежат рядом
+ * в одной структуре, так как запрос читает их вместе.
+ */
 template<typename CurGraph>
 class DFSLCADoubleUp : public DFSVisitor<CurGraph> {
  public:
@@ -14,29 +30,34 @@ class DFSLCADoubleUp : public DFSVisitor<CurGraph> {
                                      int,
                                      typename CurGraph::weight_type>::type;
   using my_type = DFSLCADoubleUp<CurGraph>;
-  using dp_type = std::vector<std::vector<int>>;
+
+  /// Данные вершины, нужные запросу
+  struct VertexInfo {
+    int in = -1;
+    int out = -1;
+    flow_type deep = 0;
+  };
 
  protected:
   int time = 0;
-  int deep = 0;
+  flow_type deep = 0;
+  int level_deep = 0;
+  int max_level_deep = 0;
   int root;
   int amount_vertex;
-  std::vector<flow_type> arr_deep;
+  int amount_levels = 0;
   std::vector<int> parent;
-  std::vector<int> arr_in;
-  std::vector<int> arr_out;
+  std::vector<VertexInfo> info;
   std::vector<flow_type> history_of_deep;
-  dp_type dp;
+  std::vector<int> ancestors;
 
  public:
 
   DFSLCADoubleUp(int root, int amount_vertex)
-      : amount_vertex(amount_vertex),
-        root(root),
+      : root(root),
+        amount_vertex(amount_vertex),
         parent(amount_vertex, root),
-        arr_deep(amount_vertex, 0),
-        arr_in(amount_vertex, -1),
-        arr_out(amount_vertex, -1) {
+        info(amount_vertex) {
 
   }
 
@@ -44,15 +65,16 @@ class DFSLCADoubleUp : public DFSVisitor<CurGraph> {
                      DFSVisitor<CurGraph>::edge_desc_iter iter,
                      DFSVisitor<CurGraph>::graph_type &graph) {
     parent[edge.second] = edge.first;
-    std::cerr << edge.first << " parent " << edge.second << "\n";
     history_of_deep.push_back(graph.GetWeightFromIter(iter));
     deep += graph.GetWeightFromIter(iter);
+    level_deep++;
+    max_level_deep = std::max(max_level_deep, level_deep);
     return false;
   }
 
   bool discover_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
-    arr_in[top] = time++;
-    arr_deep[top] = deep;
+    info[top].in = time++;
+    info[top].deep = deep;
 
     return false;
   }
@@ -62,84 +84,120 @@ class DFSLCADoubleUp : public DFSVisitor<CurGraph> {
                    DFSVisitor<CurGraph>::graph_type &graph) {
     deep -= history_of_deep.back();
     history_of_deep.pop_back();
+    level_deep--;
 
     return false;
   }
 
   void finish_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
-    arr_out[top] = time++;
+    info[top].out = time++;
   }
 
-  bool IsLeader(int x, int y) {
-    if ((arr_in[x] <= arr_in[y]) && (arr_out[x] >= arr_out[y])) return true;
+  bool IsLeader(int x, int y) const {
+    return (info[x].in <= info[y].in) && (info[x].out >= info[y].out);
+  }
 
-    return false;
+  /**
+   * @brief Число уровней таблицы подъемов: bit_width максимальной глубины дерева в ребрах.
+   */
+  [[nodiscard]] int GetAmountLevels() const {
+    return amount_levels;
   }
 
-  void FillDpForLCA(CurGraph &graph);
+  void FillDpForLCA(ThreadPool &pool);
 
   void BeReadyForLCA(CurGraph &graph);
 
-  flow_type LSA_with_distance(int x, int y, CurGraph &graph);
+  /**
+   * @brief Обход и построение таблицы, уровни которой заполняются параллельно по вершинам.
+   */
+  void BeReadyForLCA(CurGraph &graph, ThreadPool &pool);
 
-  template<typename... Args>
-  void ConstructDp(Args &&... construct_args) {
-    dp = dp_type(construct_args...);
-  }
+  int GetLCA(int x, int y) const;
+
+  flow_type LSA_with_distance(int x, int y, CurGraph &graph) const;
 
   void DeleteDp() {
-    dp.clear();
+    ancestors.clear();
+    ancestors.shrink_to_fit();
   }
 
 };
+
 template<typename CurGraph>
-void DFSLCADoubleUp<CurGraph>::FillDpForLCA(CurGraph &graph) {
-  for (int i = 0; i < 21; i++) {
-    for (int j = 0; j < amount_vertex; j++) {
-      //std::cout << i << " " << j << "\n";
-      if (i == 0) {
-        dp[j][i] = parent[j];
-      } else {
-        dp[j][i] = dp[dp[j][i - 1]][i - 1];
-      }
-      // std::cout << "dp[j][i] = " << dp[j][i] << "\n";
-    }
+void DFSLCADoubleUp<CurGraph>::FillDpForLCA(ThreadPool &pool) {
+  amount_levels = std::max(1, int(std::bit_width(unsigned(max_level_deep))));
+  ancestors.resize(std::size_t(amount_levels) * amount_vertex);
+  std::copy(parent.begin(), parent.end(), ancestors.begin());
+  for (int level = 1; level < amount_levels; level++) {
+    const int *prev = ancestors.data() + std::size_t(level - 1) * amount_vertex;
+    int *cur = ancestors.data() + std::size_t(level) * amount_vertex;
+    pool.ParallelFor(0, amount_vertex, [&](std::size_t v, std::size_t) {
+      cur[v] = prev[prev[v]];
+    });
   }
 }
 
 template<typename CurGraph>
 void DFSLCADoubleUp<CurGraph>::BeReadyForLCA(CurGraph &graph) {
+  ThreadPool pool(1);
+  BeReadyForLCA(graph, pool);
+}
+
+template<typename CurGraph>
+void DFSLCADoubleUp<CurGraph>::BeReadyForLCA(CurGraph &graph, ThreadPool &pool) {
   graph.template DFS<my_type>(root, *this);
-  this->ConstructDp(amount_vertex, std::vector(21, root));  //TODO: 21
-  this->FillDpForLCA(graph);
+  FillDpForLCA(pool);
 }
 
 template<typename CurGraph>
-DFSLCADoubleUp<CurGraph>::flow_type DFSLCADoubleUp<CurGraph>::LSA_with_distance(int x, int y, CurGraph &graph) {
-  if (IsLeader(x, y)) return arr_deep[y] - arr_deep[x];
-  if (IsLeader(y, x)) return arr_deep[x] - arr_deep[y];
+int DFSLCADoubleUp<CurGraph>::GetLCA(int x, int y) const {
+  if (IsLeader(x, y)) return x;
+  if (IsLeader(y, x)) return y;
 
   int cur_top = x;
-  for (int i = 19; i > -1; i--) {
-    if ((!IsLeader(dp[cur_top][i], y)) && (IsLeader(dp[cur_top][i + 1], y))) {
-      cur_top = dp[cur_top][i];
-    }
+  for (int level = amount_levels - 1; level >= 0; level--) {
+    int up = ancestors[std::size_t(level) * amount_vertex + cur_top];
+    if (!IsLeader(up, y)) cur_top = up;
   }
-  return arr_deep[x] + arr_deep[y] - 2 * arr_deep[parent[cur_top]];
+  return parent[cur_top];
 }
 
+template<typename CurGraph>
+DFSLCADoubleUp<CurGraph>::flow_type DFSLCADoubleUp<CurGraph>::LSA_with_distance(int x, int y, CurGraph &graph) const {
+  return info[x].deep + info[y].deep - 2 * info[GetLCA(x, y)].deep;
+}
+
+/**
+ * @brief LCA через эйлеров обход и разреженную таблицу минимумов (RMQ) по глубинам.
+ *
+ * Таблица хранится одним массивом по уровням: table[level * m + i] - пара (глубина, вершина) с минимальной
+ * глубиной на отрезке эйлерова обхода [i, i + 2^level), где m - длина обхода. Запрос читает две ячейки одного
+ * уровня, номер уровня - std::bit_width длины отрезка минус 1, без std::log2 и без косвенности через индексы.
+ */
 template<typename CurGraph>
 class DFSLCAFrakBender : public DFSVisitor<CurGraph> {
  public:
   using my_type = DFSLCAFrakBender<CurGraph>;
 
+  /// Элемент разреженной таблицы
+  struct DepthVertex {
+    int depth;
+    int top;
+  };
+
  protected:
   int deep = 0;
   int root;
   std::vector<int> first;
   std::vector<int> arr_deep;
   std::vector<int> euler;
-  std::vector<std::vector<int>> dp;
+  std::vector<DepthVertex> table;
+  std::size_t euler_size = 0;
+
+  static const DepthVertex &Min(const DepthVertex &first_elem, const DepthVertex &second_elem) {
+    return second_elem.depth < first_elem.depth ? second_elem : first_elem;
+  }
 
  public:
   DFSLCAFrakBender(int root, int amount_vertex) : root(root), first(amount_vertex, -1) {
@@ -166,76 +224,622 @@ class DFSLCAFrakBender : public DFSVisitor<CurGraph> {
     deep--;
   }
 
-  template<typename... Args>
-  void ConstructDp(Args &&... construct_args) {
-    dp = dp_type(construct_args...);
+  void DeleteDp() {
+    table.clear();
+    table.shrink_to_fit();
   }
 
-  void DeleteDp() {
-    dp.clear();
+  /**
+   * @brief Объем памяти под структуры запросов в байтах.
+   */
+  [[nodiscard]] std::size_t MemoryUsage() const {
+    return table.capacity() * sizeof(DepthVertex) + (first.capacity() + arr_deep.capacity() + euler.capacity())
+        * sizeof(int);
   }
 
   void BuildSparseTable(CurGraph &visitor);
 
-  int RMQ(int l, int r, CurGraph &graph);
+  /**
+   * @brief Вершина с минимальной глубиной на отрезке [l, r] эйлерова обхода (l и r в любом порядке).
+   */
+  int RMQ(int l, int r) const {
+    if (l > r) std::swap(l, r);
+    int level = std::bit_width(static_cast<unsigned>(r - l + 1)) - 1;
+    const DepthVertex *row = table.data() + level * euler_size;
+    return Min(row[l], row[r - (1 << level) + 1]).top;
+  }
 
   void PreprocessForLCAFrakBender(CurGraph &graph);
 
-  int GetLCA(int u, int v, CurGraph &graph);
+  int GetLCA(int u, int v, CurGraph &graph) {
+    return RMQ(first[u], first[v]);
+  }
+
+  /**
+   * @brief Пакетный запрос: answers[i] = LCA(queries[i].first, queries[i].second).
+   *
+   * @param queries Пары вершин.
+   * @param answers Выходной массив размера не меньше queries.size().
+   */
+  void GetLCA(std::span<const std::pair<int, int>> queries, std::span<int> answers) const {
+    const int *first_data = first.data();
+    const DepthVertex *table_data = table.data();
+    const std::size_t size = euler_size;
+    // Запросы обрабатываются пачками: сначала для всей пачки считаются ячейки таблицы и запрашивается их загрузка
+    // в кэш, потом читаются ответы, так что промахи разных запросов перекрываются
+    constexpr std::size_t kChunk = 16;
+    const DepthVertex *left_cell[kChunk];
+    const DepthVertex *right_cell[kChunk];
+    for (std::size_t begin = 0; begin < queries.size(); begin += kChunk) {
+      std::size_t amount = std::min(kChunk, queries.size() - begin);
+      for (std::size_t i = 0; i < amount; i++) {
+        int l = first_data[queries[begin + i].first];
+        int r = first_data[queries[begin + i].second];
+        if (l > r) std::swap(l, r);
+        int level = std::bit_width(static_cast<unsigned>(r - l + 1)) - 1;
+        const DepthVertex *row = table_data + level * size;
+        left_cell[i] = row + l;
+        right_cell[i] = row + r - (1 << level) + 1;
+#if defined(__GNUC__)
+        __builtin_prefetch(left_cell[i]);
+        __builtin_prefetch(right_cell[i]);
+#endif
+      }
+      for (std::size_t i = 0; i < amount; i++) {
+        answers[begin + i] = Min(*left_cell[i], *right_cell[i]).top;
+      }
+    }
+  }
 };
 
 template<typename CurGraph>
 void DFSLCAFrakBender<CurGraph>::BuildSparseTable(CurGraph &graph) {
+  euler_size = euler.size();
+  int amount_levels = std::bit_width(euler_size);
+  table.resize(amount_levels * euler_size);
+
+  for (std::size_t i = 0; i < euler_size; i++) {
+    table[i] = {arr_deep[i], euler[i]};
+  }
+  for (int level = 1; level < amount_levels; level++) {
+    const DepthVertex *prev = table.data() + (level - 1) * euler_size;
+    DepthVertex *cur = table.data() + level * euler_size;
+    std::size_t half = std::size_t(1) << (level - 1);
+    for (std::size_t i = 0; i + 2 * half <= euler_size; i++) {
+      cur[i] = Min(prev[i], prev[i + half]);
+    }
+  }
+}
+
+template<typename CurGraph>
+void DFSLCAFrakBender<CurGraph>::PreprocessForLCAFrakBender(CurGraph &graph) {
+
+  graph.template DFS<my_type>(root, *this);
+  BuildSparseTable(graph);
+}
+
+/**
+ * @brief Неизменяемый вид на готовые массивы схемы Фарах-Колтона и Бендера и запрос по ним.
+ *
+ * Не владеет памятью: массивы лежат либо в DFSLCAFarachColtonBender, либо в отображенном в память файле
+ * индекса (см. LCAIndex.hpp), поэтому запрос в обоих случаях один и тот же.
+ */
+struct FarachColtonBenderView {
+  using mask_type = std::uint16_t;
+
+  /// Элемент эйлерова обхода и разреженной таблицы по блокам
+  struct DepthVertex {
+    int depth;
+    int top;
+  };
+
+  const int *first = nullptr;
+  const DepthVertex *euler = nullptr;
+  const mask_type *block_mask = nullptr;
+  const DepthVertex *block_table = nullptr;
+  const std::uint8_t *in_block = nullptr;
+  std::size_t amount_vertex = 0;
+  std::size_t euler_size = 0;
+  std::size_t amount_blocks = 0;
+  int block_size = 1;
+
+  static const DepthVertex &Min(const DepthVertex &first_elem, const DepthVertex &second_elem) {
+    return second_elem.depth < first_elem.depth ? second_elem : first_elem;
+  }
+
+  [[nodiscard]] std::size_t AmountLevels() const {
+    return std::bit_width(amount_blocks);
+  }
+
+  [[nodiscard]] std::size_t InBlockTableSize() const {
+    return (std::size_t(1) << (block_size - 1)) * block_size * block_size;
+  }
+
+  /// Позиция в эйлеровом обходе минимума на [l, r] внутри одного блока
+  [[nodiscard]] int InBlockMin(std::size_t block, int l, int r) const {
+    std::size_t cell = (std::size_t(block_mask[block]) * block_size + l) * block_size + r;
+    return int(block * block_size) + in_block[cell];
+  }
+
+  /**
+   * @brief Вершина с минимальной глубиной на отрезке [l, r] эйлерова обхода (l и r в любом порядке).
+   */
+  [[nodiscard]] int RMQ(int l, int r) const {
+    if (l > r) std::swap(l, r);
+    std::size_t left_block = l / block_size;
+    std::size_t right_block = r / block_size;
+    int in_left = l - int(left_block * block_size);
+    int in_right = r - int(right_block * block_size);
+    if (left_block == right_block) {
+      return euler[InBlockMin(left_block, in_left, in_right)].top;
+    }
+    DepthVertex best = Min(euler[InBlockMin(left_block, in_left, block_size - 1)],
+                           euler[InBlockMin(right_block, 0, in_right)]);
+    if (right_block - left_block > 1) {
+      std::size_t from = left_block + 1;
+      std::size_t to = right_block - 1;
+      int level = std::bit_width(to - from + 1) - 1;
+      const DepthVertex *row = block_table + level * amount_blocks;
+      best = Min(best, Min(row[from], row[to - (std::size_t(1) << level) + 1]));
+    }
+    return best.top;
+  }
 
-  int m = euler.size();
-  int log = (int) std::log2(m) + 1;
-  dp.assign(m, std::vector<int>(log, -1));
+  [[nodiscard]] int GetLCA(int u, int v) const {
+    return RMQ(first[u], first[v]);
+  }
+};
+
+/**
+ * @brief LCA схемой Фарах-Колтона и Бендера: линейная предобработка и память, запрос за O(1).
+ *
+ * Глубины соседних элементов эйлерова обхода отличаются ровно на 1 (±1-RMQ). Обход режется на блоки длины
+ * block_size = log2(m) / 2, где m - длина обхода. Между блоками отвечает разреженная таблица по минимумам блоков,
+ * в ней O(m / block_size * log m) = O(m) ячеек. Блок описывается маской шагов глубины (бит i = 1, если глубина на
+ * шаге i -> i + 1 растет), разных масок 2^(block_size - 1) <= sqrt(m), и для каждой маски заранее посчитан ответ на
+ * все отрезки внутри блока. Запрос - не больше двух ответов внутри блоков и одного по таблице блоков.
+ */
+template<typename CurGraph>
+class DFSLCAFarachColtonBender : public DFSVisitor<CurGraph> {
+ public:
+  using my_type = DFSLCAFarachColtonBender<CurGraph>;
+  using mask_type = FarachColtonBenderView::mask_type;
+  using DepthVertex = FarachColtonBenderView::DepthVertex;
+
+ protected:
+  /// Ограничение длины блока: маска помещается в mask_type, смещение внутри блока - в uint8_t
+  static constexpr int kMaxBlockSize = 16;
+
+  int deep = 0;
+  int root;
+  std::vector<int> first;
+  std::vector<DepthVertex> euler;
+  std::size_t euler_size = 0;
+  int block_size = 1;
+  std::size_t amount_blocks = 0;
+  std::vector<mask_type> block_mask;
+  std::vector<DepthVertex> block_table;
+  std::vector<std::uint8_t> in_block;
+
+  void BuildInBlockTable();
+
+  void BuildBlockTable();
+
+ public:
+  DFSLCAFarachColtonBender(int root, int amount_vertex) : root(root), first(amount_vertex, -1) {
+
+  }
+
+  bool discover_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+    deep++;
+    euler.push_back({deep, top});
+    first[top] = euler.size() - 1;
 
-  for (int i = 0; i < m; i++) {
-    dp[i][0] = i;
+    return false;
+  }
+
+  bool finish_edge(DFSVisitor<CurGraph>::edge_desc edge,
+                   DFSVisitor<CurGraph>::edge_desc_iter iter,
+                   DFSVisitor<CurGraph>::graph_type &graph) {
+    euler.push_back({deep, edge.first});
+    return false;
   }
 
-  for (int j = 1; j < log; j++) {
-    for (int i = 0; i + (1 << j) <= m; i++) {
-      if (arr_deep[dp[i][j - 1]] < arr_deep[dp[i + (1 << (j - 1))][j - 1]]) {
-        dp[i][j] = dp[i][j - 1];
-      } else {
-        dp[i][j] = dp[i + (1 << (j - 1))][j - 1];
+  void finish_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+    deep--;
+  }
+
+  void PreprocessForLCA(CurGraph &graph);
+
+  /**
+   * @brief Вид на построенные массивы; действителен, пока объект жив и не перестраивается.
+   */
+  [[nodiscard]] FarachColtonBenderView GetView() const {
+    return {first.data(), euler.data(), block_mask.data(), block_table.data(), in_block.data(),
+            first.size(), euler_size, amount_blocks, block_size};
+  }
+
+  /**
+   * @brief Вершина с минимальной глубиной на отрезке [l, r] эйлерова обхода (l и r в любом порядке).
+   */
+  [[nodiscard]] int RMQ(int l, int r) const {
+    return GetView().RMQ(l, r);
+  }
+
+  int GetLCA(int u, int v, CurGraph &graph) const {
+    return RMQ(first[u], first[v]);
+  }
+
+  /**
+   * @brief Объем памяти под структуры запросов в байтах.
+   */
+  [[nodiscard]] std::size_t MemoryUsage() const {
+    return first.capacity() * sizeof(int) + (euler.capacity() + block_table.capacity()) * sizeof(DepthVertex)
+        + block_mask.capacity() * sizeof(mask_type)
+        + in_block.capacity();
+  }
+};
+
+template<typename CurGraph>
+void DFSLCAFarachColtonBender<CurGraph>::BuildInBlockTable() {
+  std::size_t amount_masks = std::size_t(1) << (block_size - 1);
+  in_block.assign(amount_masks * block_size * block_size, 0);
+  std::vector<int> depth(block_size);
+  for (std::size_t mask = 0; mask < amount_masks; mask++) {
+    for (int i = 1; i < block_size; i++) {
+      depth[i] = depth[i - 1] + (((mask >> (i - 1)) & 1) ? 1 : -1);
+    }
+    std::uint8_t *cell = in_block.data() + mask * block_size * block_size;
+    for (int l = 0; l < block_size; l++) {
+      int best = l;
+      for (int r = l; r < block_size; r++) {
+        if (depth[r] < depth[best]) best = r;
+        cell[l * block_size + r] = std::uint8_t(best);
       }
     }
   }
 }
 
 template<typename CurGraph>
-int DFSLCAFrakBender<CurGraph>::RMQ(int l, int r, CurGraph &graph) {
+void DFSLCAFarachColtonBender<CurGraph>::BuildBlockTable() {
+  int amount_levels = std::bit_width(amount_blocks);
+  block_table.resize(amount_levels * amount_blocks);
+  FarachColtonBenderView view = GetView();
+  for (std::size_t block = 0; block < amount_blocks; block++) {
+    int last = int(std::min(euler_size, (block + 1) * block_size)) - 1;
+    block_table[block] = euler[view.InBlockMin(block, 0, last - int(block * block_size))];
+  }
+  for (int level = 1; level < amount_levels; level++) {
+    const DepthVertex *prev = block_table.data() + (level - 1) * amount_blocks;
+    DepthVertex *cur = block_table.data() + level * amount_blocks;
+    std::size_t half = std::size_t(1) << (level - 1);
+    for (std::size_t i = 0; i + 2 * half <= amount_blocks; i++) {
+      cur[i] = FarachColtonBenderView::Min(prev[i], prev[i + half]);
+    }
+  }
+}
+
+template<typename CurGraph>
+void DFSLCAFarachColtonBender<CurGraph>::PreprocessForLCA(CurGraph &graph) {
+  graph.template DFS<my_type>(root, *this);
+  euler.shrink_to_fit();
+  euler_size = euler.size();
+  block_size = std::clamp(int(std::bit_width(euler_size)) / 2, 1, kMaxBlockSize);
+  amount_blocks = (euler_size + block_size - 1) / block_size;
+
+  // Недостающие шаги последнего неполного блока считаются ростом глубины, поэтому минимум в них не попадает
+  block_mask.assign(amount_blocks, 0);
+  for (std::size_t block = 0; block < amount_blocks; block++) {
+    std::size_t begin = block * block_size;
+    mask_type mask = 0;
+    for (int i = 1; i < block_size; i++) {
+      std::size_t pos = begin + i;
+      if (pos >= euler_size || euler[pos].depth > euler[pos - 1].depth) mask |= mask_type(1) << (i - 1);
+    }
+    block_mask[block] = mask;
+  }
+  BuildInBlockTable();
+  BuildBlockTable();
+}
+
+/**
+ * @brief Оффлайн LCA Тарьяна: один DFS отвечает на всю пачку запросов через систему непересекающихся множеств.
+ *
+ * Запросы раскладываются по вершинам в CSR (для каждой вершины - вторые концы ее запросов и номера запросов).
+ * Когда обработка вершины v закончена, для каждого запроса (v, w) с уже законченной w ответом служит текущий
+ * предок множества w. После возврата по ребру (u, v) множество v сливается с множеством u, а предком объединения
+ * становится u. Таблиц размера O(n log n) нет, память - O(n + q).
+ */
+template<typename CurGraph>
+class DFSLCATarjan : public DFSVisitor<CurGraph> {
+ public:
+  using flow_type = std::conditional<std::is_same_v<typename CurGraph::weight_type, bool>,
+                                     int,
+                                     typename CurGraph::weight_type>::type;
+  using my_type = DFSLCATarjan<CurGraph>;
+
+ protected:
+  int root;
+  int amount_vertex;
+  flow_type deep = 0;
+  std::vector<flow_type> arr_deep;
+  std::vector<flow_type> history_of_deep;
+  std::vector<bool> finished;
+  std::vector<int> dsu_parent;
+  std::vector<int> dsu_size;
+  std::vector<int> ancestor;
+  std::vector<int> query_begin;
+  std::vector<std::pair<int, int>> query_other;
+  std::span<int> lca;
+
+  int Find(int top) {
+    while (dsu_parent[top] != top) {
+      dsu_parent[top] = dsu_parent[dsu_parent[top]];
+      top = dsu_parent[top];
+    }
+    return top;
+  }
+
+  void Union(int child, int top) {
+    int first_set = Find(child);
+    int second_set = Find(top);
+    if (dsu_size[first_set] > dsu_size[second_set]) std::swap(first_set, second_set);
+    dsu_parent[first_set] = second_set;
+    dsu_size[second_set] += dsu_size[first_set];
+    ancestor[second_set] = top;
+  }
+
+  void BuildQueries(std::span<const std::pair<int, int>> queries);
+
+ public:
+  DFSLCATarjan(int root, int amount_vertex) : root(root), amount_vertex(amount_vertex) {
 
-  std::cerr << "RMQ begin l =" << l << " r = " << r << "\n";
-  if (l > r) {
-    std::cerr << "EEERRRRRRRRROOOOOOORRRRRRR\n";
-    return -1;
   }
-  int log = (int) std::log2(r - l + 1);
-  if (arr_deep[dp[l][log]] < arr_deep[dp[r - (1 << log) + 1][log]]) {
-    return dp[l][log];
-  } else {
-    return dp[r - (1 << log) + 1][log];
+
+  bool tree_edge_DFS(DFSVisitor<CurGraph>::edge_desc edge,
+                     DFSVisitor<CurGraph>::edge_desc_iter iter,
+                     DFSVisitor<CurGraph>::graph_type &graph) {
+    history_of_deep.push_back(graph.GetWeightFromIter(iter));
+    deep += graph.GetWeightFromIter(iter);
+    return false;
+  }
+
+  bool discover_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+    arr_deep[top] = deep;
+    return false;
+  }
+
+  bool finish_edge(DFSVisitor<CurGraph>::edge_desc edge,
+                   DFSVisitor<CurGraph>::edge_desc_iter iter,
+                   DFSVisitor<CurGraph>::graph_type &graph) {
+    deep -= history_of_deep.back();
+    history_of_deep.pop_back();
+    Union(edge.second, edge.first);
+    return false;
+  }
+
+  void finish_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+    finished[top] = true;
+    for (int i = query_begin[top]; i < query_begin[top + 1]; i++) {
+      auto [other, index] = query_other[i];
+      if (finished[other]) lca[index] = ancestor[Find(other)];
+    }
+  }
+
+  /**
+   * @brief Отвечает на пачку запросов одним обходом из корня.
+   *
+   * Для вершин, недостижимых из корня, lca равно -1, а расстояние - INT_MAXIMUS.
+   *
+   * @param queries Пары вершин.
+   * @param answers_lca Выход: LCA каждой пары, размер не меньше queries.size().
+   * @param answers_distance Выход: взвешенное расстояние между вершинами пары, как в LSA_with_distance.
+   */
+  void AnswerQueries(CurGraph &graph,
+                     std::span<const std::pair<int, int>> queries,
+                     std::span<int> answers_lca,
+                     std::span<flow_type> answers_distance);
+};
+
+template<typename CurGraph>
+void DFSLCATarjan<CurGraph>::BuildQueries(std::span<const std::pair<int, int>> queries) {
+  query_begin.assign(amount_vertex + 1, 0);
+  for (auto [u, v] : queries) {
+    query_begin[u + 1]++;
+    query_begin[v + 1]++;
+  }
+  for (int top = 0; top < amount_vertex; top++) {
+    query_begin[top + 1] += query_begin[top];
+  }
+  query_other.resize(2 * queries.size());
+  std::vector<int> position(query_begin.begin(), query_begin.end() - 1);
+  for (std::size_t i = 0; i < queries.size(); i++) {
+    auto [u, v] = queries[i];
+    query_other[position[u]++] = {v, int(i)};
+    query_other[position[v]++] = {u, int(i)};
   }
 }
 
 template<typename CurGraph>
-void DFSLCAFrakBender<CurGraph>::PreprocessForLCAFrakBender(CurGraph &graph) {
+void DFSLCATarjan<CurGraph>::AnswerQueries(CurGraph &graph,
+                                           std::span<const std::pair<int, int>> queries,
+                                           std::span<int> answers_lca,
+                                           std::span<flow_type> answers_distance) {
+  deep = 0;
+  history_of_deep.clear();
+  arr_deep.assign(amount_vertex, 0);
+  finished.assign(amount_vertex, false);
+  dsu_parent.resize(amount_vertex);
+  std::iota(dsu_parent.begin(), dsu_parent.end(), 0);
+  dsu_size.assign(amount_vertex, 1);
+  ancestor = dsu_parent;
+  BuildQueries(queries);
+  lca = answers_lca.first(queries.size());
+  std::fill(lca.begin(), lca.end(), -1);
 
   graph.template DFS<my_type>(root, *this);
-  BuildSparseTable(graph);
+
+  for (std::size_t i = 0; i < queries.size(); i++) {
+    if (lca[i] == -1) {
+      answers_distance[i] = INT_MAXIMUS;
+    } else {
+      answers_distance[i] = arr_deep[queries[i].first] + arr_deep[queries[i].second] - 2 * arr_deep[lca[i]];
+    }
+  }
+}
+
+/**
+ * @brief Тяжело-легкая декомпозиция дерева: сумма, минимум и максимум весов ребер на пути u - v и смена веса ребра.
+ *
+ * Один DFS из корня дает родителей, глубины, веса ребер к родителям и размеры поддеревьев, тяжелый сын - сын
+ * с наибольшим поддеревом. Затем вершины в порядке обхода раскладываются по тяжелым путям так, чтобы каждый путь
+ * занимал отрезок позиций подряд. Вес ребра (parent[v], v) хранится в позиции v в дереве отрезков, узел которого
+ * держит сразу все три агрегата. Путь u - v пересекает O(log n) тяжелых путей, так что запрос - O(log^2 n),
+ * а смена веса - одно изменение листа за O(log n) без перестройки.
+ */
+template<typename CurGraph>
+class DFSHeavyLight : public DFSVisitor<CurGraph> {
+ public:
+  using flow_type = std::conditional<std::is_same_v<typename CurGraph::weight_type, bool>,
+                                     int,
+                                     typename CurGraph::weight_type>::type;
+  using my_type = DFSHeavyLight<CurGraph>;
+
+  /// Агрегаты весов ребер на пути
+  struct PathAggregate {
+    flow_type sum = 0;
+    flow_type min = std::numeric_limits<flow_type>::max();
+    flow_type max = std::numeric_limits<flow_type>::lowest();
+  };
+
+  struct CombineAggregate {
+    PathAggregate operator()(const PathAggregate &first_elem, const PathAggregate &second_elem) const {
+      return {first_elem.sum + second_elem.sum,
+              std::min(first_elem.min, second_elem.min),
+              std::max(first_elem.max, second_elem.max)};
+    }
+  };
+
+ protected:
+  int root;
+  int amount_vertex;
+  std::vector<int> parent;
+  std::vector<int> depth;
+  std::vector<int> subtree_size;
+  std::vector<int> heavy;
+  std::vector<int> head;
+  std::vector<int> pos;
+  std::vector<int> order;
+  std::vector<flow_type> weight_to_parent;
+  SegmentTree<PathAggregate, CombineAggregate> tree;
+
+  void Decompose();
+
+ public:
+  DFSHeavyLight(int root, int amount_vertex)
+      : root(root),
+        amount_vertex(amount_vertex),
+        parent(amount_vertex, -1),
+        depth(amount_vertex, 0),
+        subtree_size(amount_vertex, 1),
+        heavy(amount_vertex, -1),
+        head(amount_vertex, -1),
+        pos(amount_vertex, -1),
+        weight_to_parent(amount_vertex, 0) {
+
+  }
+
+  bool tree_edge_DFS(DFSVisitor<CurGraph>::edge_desc edge,
+                     DFSVisitor<CurGraph>::edge_desc_iter iter,
+                     DFSVisitor<CurGraph>::graph_type &graph) {
+    parent[edge.second] = edge.first;
+    depth[edge.second] = depth[edge.first] + 1;
+    weight_to_parent[edge.second] = graph.GetWeightFromIter(iter);
+    return false;
+  }
+
+  bool discover_vertex_DFS(DFSVisitor<CurGraph>::vert_desc top, DFSVisitor<CurGraph>::graph_type &graph) {
+    order.push_back(top);
+    return false;
+  }
+
+  bool finish_edge(DFSVisitor<CurGraph>::edge_desc edge,
+                   DFSVisitor<CurGraph>::edge_desc_iter iter,
+                   DFSVisitor<CurGraph>::graph_type &graph) {
+    subtree_size[edge.first] += subtree_size[edge.second];
+    if (heavy[edge.first] == -1 || subtree_size[edge.second] > subtree_size[heavy[edge.first]]) {
+      heavy[edge.first] = edge.second;
+    }
+    return false;
+  }
+
+  void BeReadyForPathQueries(CurGraph &graph);
+
+  /**
+   * @brief Сумма, минимум и максимум весов ребер на пути u - v (для u == v - нейтральные значения).
+   *
+   * Обе вершины должны быть достижимы из корня.
+   */
+  PathAggregate QueryPath(int u, int v) const;
+
+  int GetLCA(int u, int v) const;
+
+  int GetParent(int top) const {
+    return parent[top];
+  }
+
+  /**
+   * @brief Меняет вес ребра дерева (u, v) в структуре запросов; сам граф не меняется.
+   */
+  void SetEdgeWeight(int u, int v, flow_type weight) {
+    int child = (parent[v] == u) ? v : u;
+    weight_to_parent[child] = weight;
+    tree.Update(pos[child], {weight, weight, weight});
+  }
+};
+
+template<typename CurGraph>
+void DFSHeavyLight<CurGraph>::Decompose() {
+  std::vector<PathAggregate> leaves(amount_vertex);
+  int cur_pos = 0;
+  for (int top : order) {
+    if (top != root && heavy[parent[top]] == top) continue;
+    for (int cur = top; cur != -1; cur = heavy[cur]) {
+      head[cur] = top;
+      pos[cur] = cur_pos++;
+      if (cur != root) leaves[pos[cur]] = {weight_to_parent[cur], weight_to_parent[cur], weight_to_parent[cur]};
+    }
+  }
+  tree = SegmentTree<PathAggregate, CombineAggregate>(leaves, PathAggregate());
 }
 
 template<typename CurGraph>
-int DFSLCAFrakBender<CurGraph>::GetLCA(int u, int v, CurGraph &graph) {
+void DFSHeavyLight<CurGraph>::BeReadyForPathQueries(CurGraph &graph) {
+  graph.template DFS<my_type>(root, *this);
+  Decompose();
+}
 
-  int left = first[u];
-  int right = first[v];
-  int ind = RMQ(left, right, graph);
-  return euler[ind];
+template<typename CurGraph>
+DFSHeavyLight<CurGraph>::PathAggregate DFSHeavyLight<CurGraph>::QueryPath(int u, int v) const {
+  CombineAggregate combine;
+  PathAggregate result;
+  while (head[u] != head[v]) {
+    if (depth[head[u]] < depth[head[v]]) std::swap(u, v);
+    result = combine(result, tree.Query(pos[head[u]], pos[u] + 1));
+    u = parent[head[u]];
+  }
+  if (depth[u] > depth[v]) std::swap(u, v);
+  // Позиция u - ребро над LCA, оно в путь не входит
+  return combine(result, tree.Query(pos[u] + 1, pos[v] + 1));
+}
+
+template<typename CurGraph>
+int DFSHeavyLight<CurGraph>::GetLCA(int u, int v) const {
+  while (head[u] != head[v]) {
+    if (depth[head[u]] < depth[head[v]]) std::swap(u, v);
+    u = parent[head[u]];
+  }
+  return depth[u] < depth[v] ? u : v;
 }
 
 #endif //GRAPHALKO_HEADERS_VISITORSHEADERS_LCAVISITORS_HPP_
@@ -5,60 +5,527 @@
 #ifndef GRAPHALKO_HEADERS_VISITORSHEADERS_SHORTESTPATHVISITORS_HPP_
 #define GRAPHALKO_HEADERS_VISITORSHEADERS_SHORTESTPATHVISITORS_HPP_
 #include"Visitors.hpp"
+#include "AlignedAllocator.hpp"
+#include "PriorityQueues.hpp"
+#include "ThreadPool.hpp"
 
+#include <climits>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Способ подсчета расстояний между всеми парами вершин в FloydWarshallVisitor.
+ */
+enum class APSPMode {
+  /// Выбор по плотности графа: на разреженных - kParallelDejkstra, на плотных - Флойд
+  kAuto,
+  /// Блочный Флойд-Уоршелл в одном потоке
+  kFloydWarshall,
+  /// Блочный Флойд-Уоршелл, независимые блоки каждой фазы раздаются потокам пула
+  kParallelFloydWarshall,
+  /// Дейкстра из каждой вершины, источники раздаются потокам пула. Отрицательные веса убираются
+  /// потенциалами Беллмана-Форда (схема Джонсона)
+  kParallelDejkstra
+};
+
+/**
+ * @brief Флойд-Уоршелл по блокам на плоской выровненной матрице расстояний.
+ *
+ * Матрица хранится построчно, число строк округлено вверх до kBlockSize, и разбита на квадратные блоки
+ * kBlockSize x kBlockSize. Для каждого блока k сначала пересчитывается диагональный блок (k, k), затем блоки его строки
+ * и столбца, затем все остальные блоки: C = min(C, A + B), где A - блок столбца k, B - блок строки k. Три блока
+ * помещаются в кэш, а внутренний цикл - векторный min-plus без ветвлений (AVX2, SSE4.1 или скалярный запасной вариант).
+ * Отсутствие пути - явное значение kInfinity, а не 0.
+ *
+ * Перегрузка FloydWarshell с ThreadPool умеет считать то же самое параллельно (см. APSPMode).
+ */
 template<typename CurGraph>
 class FloydWarshallVisitor {
  protected:
   using graph_type = CurGraph;
   using vert_desc = int;
+  /// Сторона блока. Три блока int по 16Кб помещаются в L1/L2
+  static constexpr std::size_t kBlockSize = 64;
+  /// "Бесконечность": сумма двух таких значений не переполняет int
+  static constexpr int kInfinity = INT_MAX / 4;
+
+  /// Добавка к шагу строки: при шаге-степени двойки строки блока попадают в одни и те же наборы кэша
+  static constexpr std::size_t kStridePadding = 16;
+
+  /// Дейкстра из каждой вершины выгоднее Флойда, если E * kDejkstraEdgeCost < V^2 (замерено на V = 2048)
+  static constexpr std::size_t kDejkstraEdgeCost = 48;
+
   int amount_vertex;
-  std::vector<std::vector<int>> dist;
+  std::size_t amount_blocks;
+  std::size_t stride;
+  std::vector<int, AlignedAllocator<int>> dist;
+  std::size_t amount_edges = 0;
+  bool has_negative_weight = false;
+  APSPMode used_mode = APSPMode::kFloydWarshall;
+
+  /**
+   * @brief c_row[j] = min(c_row[j], a + b_row[j]) для строки блока.
+   */
+  static void MinPlusRow(int *c_row, const int *b_row, int a) {
+#if defined(__AVX2__)
+    __m256i a_vec = _mm256_set1_epi32(a);
+    for (std::size_t j = 0; j < kBlockSize; j += 8) {
+      __m256i c_vec = _mm256_load_si256(reinterpret_cast<const __m256i *>(c_row + j));
+      __m256i b_vec = _mm256_load_si256(reinterpret_cast<const __m256i *>(b_row + j));
+      c_vec = _mm256_min_epi32(c_vec, _mm256_add_epi32(a_vec, b_vec));
+      _mm256_store_si256(reinterpret_cast<__m256i *>(c_row + j), c_vec);
+    }
+#elif defined(__SSE4_1__)
+    __m128i a_vec = _mm_set1_epi32(a);
+    for (std::size_t j = 0; j < kBlockSize; j += 4) {
+      __m128i c_vec = _mm_load_si128(reinterpret_cast<const __m128i *>(c_row + j));
+      __m128i b_vec = _mm_load_si128(reinterpret_cast<const __m128i *>(b_row + j));
+      c_vec = _mm_min_epi32(c_vec, _mm_add_epi32(a_vec, b_vec));
+      _mm_store_si128(reinterpret_cast<__m128i *>(c_row + j), c_vec);
+    }
+#else
+    for (std::size_t j = 0; j < kBlockSize; j++) {
+      c_row[j] = std::min(c_row[j], a + b_row[j]);
+    }
+#endif
+  }
+
+  /**
+   * @brief Пересчет блока c через блоки a и b, которые могут совпадать с c (фазы 1 и 2).
+   *
+   * Внешний цикл по k, как в обычном Флойде, поэтому результат корректен при совпадении блоков.
+   */
+  void RelaxDependentBlock(int *c, const int *a, const int *b) {
+    for (std::size_t k = 0; k < kBlockSize; k++) {
+      const int *b_row = b + k * stride;
+      for (std::size_t i = 0; i < kBlockSize; i++) {
+        MinPlusRow(c + i * stride, b_row, a[i * stride + k]);
+      }
+    }
+  }
+
+  /**
+   * @brief Пересчет блока c, не совпадающего с a и b (фаза 3).
+   *
+   * Строка c целиком держится в регистрах, пока по ней проходят все k.
+   */
+  void RelaxIndependentBlock(int *c, const int *a, const int *b) {
+    for (std::size_t i = 0; i < kBlockSize; i++) {
+      int *c_row = c + i * stride;
+      const int *a_row = a + i * stride;
+#if defined(__AVX2__)
+      constexpr std::size_t kLanes = 8;
+      __m256i acc[kBlockSize / kLanes];
+      for (std::size_t v = 0; v < kBlockSize / kLanes; v++) {
+        acc[v] = _mm256_load_si256(reinterpret_cast<const __m256i *>(c_row + v * kLanes));
+      }
+      for (std::size_t k = 0; k < kBlockSize; k++) {
+        __m256i a_vec = _mm256_set1_epi32(a_row[k]);
+        const int *b_row = b + k * stride;
+        for (std::size_t v = 0; v < kBlockSize / kLanes; v++) {
+          __m256i b_vec = _mm256_load_si256(reinterpret_cast<const __m256i *>(b_row + v * kLanes));
+          acc[v] = _mm256_min_epi32(acc[v], _mm256_add_epi32(a_vec, b_vec));
+        }
+      }
+      for (std::size_t v = 0; v < kBlockSize / kLanes; v++) {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(c_row + v * kLanes), acc[v]);
+      }
+#else
+      alignas(64) int acc[kBlockSize];
+      std::copy(c_row, c_row + kBlockSize, acc);
+      for (std::size_t k = 0; k < kBlockSize; k++) {
+        MinPlusRow(acc, b + k * stride, a_row[k]);
+      }
+      std::copy(acc, acc + kBlockSize, c_row);
+#endif
+    }
+  }
+
+  int *Block(std::size_t block_row, std::size_t block_col) {
+    return dist.data() + block_row * kBlockSize * stride + block_col * kBlockSize;
+  }
+
+  void LoadMatrix(CurGraph &graph);
+  void BlockedFloydWarshall(ThreadPool *pool);
+  bool BellmanFordPotentials(const std::vector<int> &offsets, const std::vector<int> &targets,
+                             const std::vector<int> &weights, std::vector<int> &potential);
+  void ParallelDejkstra(ThreadPool &pool);
 
  public:
 
-  FloydWarshallVisitor(int amount_vertex) : amount_vertex(amount_vertex),
-                                            dist(amount_vertex, std::vector<int>(amount_vertex, 0)) {};
+  FloydWarshallVisitor(int amount_vertex)
+      : amount_vertex(amount_vertex),
+        amount_blocks((amount_vertex + kBlockSize - 1) / kBlockSize),
+        stride(amount_blocks * kBlockSize + kStridePadding),
+        dist(amount_blocks * kBlockSize * stride, kInfinity) {};
 
   void PrintDist() {
     std::cerr << "dist \n";
-    for (auto &i : dist) {
-      for (std::size_t j = 0; j < dist.size(); j++) {
-        std::cerr << " " << i[j];
+    for (int i = 0; i < amount_vertex; i++) {
+      for (int j = 0; j < amount_vertex; j++) {
+        std::cerr << " " << GetDist(i, j);
       }
       std::cerr << "\n";
     }
   }
 
+  /**
+   * @brief Длина кратчайшего пути или -1, если пути нет.
+   */
   int GetDist(int from, int to) {
-    if((from != to) && dist[from][to] == 0) {
+    int cur = dist[from * stride + to];
+    if (cur >= kInfinity / 2) {
       return -1;
     }
-    return dist[from][to];
+    return cur;
+  }
+
+  /**
+   * @brief Режим, которым были посчитаны расстояния при последнем вызове (kAuto раскрывается в конкретный).
+   */
+  APSPMode GetUsedMode() const {
+    return used_mode;
   }
 
   void FloydWarshell(CurGraph &graph);
+
+  /**
+   * @brief Расстояния между всеми парами вершин на потоках пула.
+   *
+   * @param pool Пул потоков.
+   * @param mode Способ подсчета, по умолчанию выбирается по числу ребер относительно V^2.
+   */
+  void FloydWarshell(CurGraph &graph, ThreadPool &pool, APSPMode mode = APSPMode::kAuto);
 };
 
+template<typename CurGraph>
+void FloydWarshallVisitor<CurGraph>::LoadMatrix(CurGraph &graph) {
+  auto matrix = graph.GetMatrixNear();
+  std::fill(dist.begin(), dist.end(), kInfinity);
+  amount_edges = 0;
+  has_negative_weight = false;
+  for (int i = 0; i < amount_vertex; i++) {
+    for (int j = 0; j < amount_vertex; j++) {
+      if (i == j) {
+        dist[i * stride + j] = 0;
+      } else if (matrix[i][j] != 0) {
+        dist[i * stride + j] = matrix[i][j];
+        amount_edges++;
+        has_negative_weight |= matrix[i][j] < 0;
+      }
+    }
+  }
+}
+
+/*
+ * Фазы блочного Флойда для блока k: диагональный блок, затем блоки строки и столбца k, затем остальные.
+ * Блоки внутри фаз 2 и 3 независимы, поэтому при pool != nullptr каждая из этих фаз - один ParallelFor.
+ */
+template<typename CurGraph>
+void FloydWarshallVisitor<CurGraph>::BlockedFloydWarshall(ThreadPool *pool) {
+  auto for_each_task = [&](std::size_t amount_tasks, auto &&func) {
+    if (pool == nullptr) {
+      for (std::size_t task = 0; task < amount_tasks; task++) {
+        func(task);
+      }
+    } else {
+      pool->ParallelFor(0, amount_tasks, [&](std::size_t task, std::size_t thread_id) { func(task); });
+    }
+  };
+
+  std::size_t amount_other = amount_blocks - 1;
+  for (std::size_t k = 0; k < amount_blocks; k++) {
+    int *diagonal = Block(k, k);
+    RelaxDependentBlock(diagonal, diagonal, diagonal);
+    // Номер блока среди amount_other блоков, отличных от k
+    auto skip_k = [k](std::size_t other) { return other < k ? other : other + 1; };
+    for_each_task(2 * amount_other, [&](std::size_t task) {
+      std::size_t other = skip_k(task / 2);
+      if (task % 2 == 0) {
+        RelaxDependentBlock(Block(k, other), diagonal, Block(k, other));
+      } else {
+        RelaxDependentBlock(Block(other, k), Block(other, k), diagonal);
+      }
+    });
+    for_each_task(amount_other * amount_other, [&](std::size_t task) {
+      std::size_t i = skip_k(task / amount_other);
+      std::size_t j = skip_k(task % amount_other);
+      RelaxIndependentBlock(Block(i, j), Block(i, k), Block(k, j));
+    });
+  }
+}
+
 template<typename CurGraph>
 void FloydWarshallVisitor<CurGraph>::FloydWarshell(CurGraph &graph) {
-  dist = graph.GetMatrixNear();
-  PrintDist();
-  std::cerr << "storage.size() = " << amount_vertex;
-
-  for (std::size_t i = 0; i < amount_vertex; i++) {
-    for (std::size_t j = 0; j < amount_vertex; j++) {
-      for (std::size_t k = 0; k < amount_vertex; k++) {
-        if ((dist[j][i] != 0) && (dist[i][k] != 0)) {
-          if ((dist[j][k] == 0) && (j != k)) {
-            dist[j][k] = dist[j][i] + dist[i][k];
-          } else {
-            dist[j][k] = std::min(dist[j][k], dist[j][i] + dist[i][k]);
-          }
+  LoadMatrix(graph);
+  used_mode = APSPMode::kFloydWarshall;
+  BlockedFloydWarshall(nullptr);
+}
+
+/*
+ * Потенциалы Джонсона: расстояния от фиктивной вершины, соединенной со всеми ребрами веса 0.
+ * Возвращает false, если в графе есть отрицательный цикл.
+ */
+template<typename CurGraph>
+bool FloydWarshallVisitor<CurGraph>::BellmanFordPotentials(const std::vector<int> &offsets,
+                                                           const std::vector<int> &targets,
+                                                           const std::vector<int> &weights,
+                                                           std::vector<int> &potential) {
+  potential.assign(amount_vertex, 0);
+  for (int round = 0; round <= amount_vertex; round++) {
+    bool changed = false;
+    for (int from = 0; from < amount_vertex; from++) {
+      for (int edge = offsets[from]; edge < offsets[from + 1]; edge++) {
+        if (potential[from] + weights[edge] < potential[targets[edge]]) {
+          potential[targets[edge]] = potential[from] + weights[edge];
+          changed = true;
+        }
+      }
+    }
+    if (!changed) return true;
+  }
+  return false;
+}
+
+template<typename CurGraph>
+void FloydWarshallVisitor<CurGraph>::ParallelDejkstra(ThreadPool &pool) {
+  std::vector<int> offsets(amount_vertex + 1, 0);
+  std::vector<int> targets;
+  std::vector<int> weights;
+  targets.reserve(amount_edges);
+  weights.reserve(amount_edges);
+  for (int from = 0; from < amount_vertex; from++) {
+    offsets[from] = targets.size();
+    for (int to = 0; to < amount_vertex; to++) {
+      if (to != from && dist[from * stride + to] != kInfinity) {
+        targets.push_back(to);
+        weights.push_back(dist[from * stride + to]);
+      }
+    }
+  }
+  offsets[amount_vertex] = targets.size();
+
+  std::vector<int> potential(amount_vertex, 0);
+  if (has_negative_weight) {
+    if (!BellmanFordPotentials(offsets, targets, weights, potential)) {
+      used_mode = pool.size() > 1 ? APSPMode::kParallelFloydWarshall : APSPMode::kFloydWarshall;
+      BlockedFloydWarshall(pool.size() > 1 ? &pool : nullptr);
+      return;
+    }
+    for (int from = 0; from < amount_vertex; from++) {
+      for (int edge = offsets[from]; edge < offsets[from + 1]; edge++) {
+        weights[edge] += potential[from] - potential[targets[edge]];
+      }
+    }
+  }
+
+  std::vector<IndexedDaryHeap<4>> queues(pool.size(), IndexedDaryHeap<4>(amount_vertex));
+  pool.ParallelFor(0, amount_vertex, [&](std::size_t begin_top, std::size_t thread_id) {
+    int *row = dist.data() + begin_top * stride;
+    std::fill(row, row + amount_vertex, kInfinity);
+    auto &queue = queues[thread_id];
+    row[begin_top] = 0;
+    queue.Push(begin_top, 0);
+    while (!queue.empty()) {
+      auto [v_dist, v_vert] = queue.Top();
+      queue.Pop();
+      for (int edge = offsets[v_vert]; edge < offsets[v_vert + 1]; edge++) {
+        int new_dist = v_dist + weights[edge];
+        if (new_dist < row[targets[edge]]) {
+          row[targets[edge]] = new_dist;
+          queue.Push(targets[edge], new_dist);
         }
       }
     }
+    if (has_negative_weight) {
+      for (int to = 0; to < amount_vertex; to++) {
+        if (row[to] != kInfinity) row[to] += potential[to] - potential[begin_top];
+      }
+    }
+  });
+}
+
+template<typename CurGraph>
+void FloydWarshallVisitor<CurGraph>::FloydWarshell(CurGraph &graph, ThreadPool &pool, APSPMode mode) {
+  LoadMatrix(graph);
+  if (mode == APSPMode::kAuto) {
+    std::size_t square = std::size_t(amount_vertex) * amount_vertex;
+    if (amount_edges * kDejkstraEdgeCost < square) {
+      mode = APSPMode::kParallelDejkstra;
+    } else {
+      mode = pool.size() > 1 ? APSPMode::kParallelFloydWarshall : APSPMode::kFloydWarshall;
+    }
+  }
+  used_mode = mode;
+  switch (mode) {
+    case APSPMode::kParallelDejkstra:
+      ParallelDejkstra(pool);
+      break;
+    case APSPMode::kParallelFloydWarshall:
+      BlockedFloydWarshall(&pool);
+      break;
+    default:
+      BlockedFloydWarshall(nullptr);
+  }
+}
+
+/**
+ * @brief Битово-параллельный BFS сразу из Width источников (MS-BFS, Then и др.).
+ *
+ * У каждой вершины три набора источников по биту на источник: seen - источники, уже дошедшие до вершины, visit -
+ * дошедшие на текущем уровне, visit_next - дошедшие на следующем. Один просмотр списка смежности вершины
+ * продвигает все ее источники разом: visit_next[u] |= visit[v]. Наборы - массивы 64-битных слов, операции над
+ * ними компилятор векторизует, а новые биты перебираются через countr_zero.
+ *
+ * Источников больше Width обрабатываются пачками по Width.
+ *
+ * @tparam Width Число одновременных обходов, кратно 64 (64, 256, 512).
+ */
+template<typename CurGraph, std::size_t Width = 64>
+class MultiSourceBFS {
+  static_assert(Width % 64 == 0 && Width > 0);
+
+ public:
+  /// Набор источников: бит i - источник с номером i в пачке
+  struct alignas(std::min<std::size_t>(Width / 8, 64)) SourceSet {
+    static constexpr std::size_t kWords = Width / 64;
+    std::uint64_t words[kWords] = {};
+
+    [[nodiscard]] bool Any() const {
+      std::uint64_t result = 0;
+      for (std::size_t i = 0; i < kWords; i++) result |= words[i];
+      return result != 0;
+    }
+
+    void Set(std::size_t bit) {
+      words[bit / 64] |= std::uint64_t(1) << (bit % 64);
+    }
+
+    template<typename Func>
+    void ForEach(Func &&func) const {
+      for (std::size_t i = 0; i < kWords; i++) {
+        for (std::uint64_t bits = words[i]; bits != 0; bits &= bits - 1) {
+          func(i * 64 + std::countr_zero(bits));
+        }
+      }
+    }
+  };
+
+  /// Сводка по одному источнику: сумма расстояний и число достигнутых вершин (для closeness) и эксцентриситет
+  struct SourceStatistic {
+    long long sum_distance = 0;
+    int amount_reached = 0;
+    int eccentricity = 0;
+  };
+
+ protected:
+  CurGraph &graph;
+  std::size_t amount_vertex;
+  std::vector<SourceSet> seen;
+  std::vector<SourceSet> visit;
+  std::vector<SourceSet> visit_next;
+
+ public:
+  explicit MultiSourceBFS(CurGraph &graph) : graph(graph), amount_vertex(graph.size()) {}
+
+  /**
+   * @brief Один совместный обход не больше чем из Width источников.
+   *
+   * @param sources Источники, источник sources[i] - бит i.
+   * @param on_visit on_visit(top, level, newly): newly - источники, впервые дошедшие до top на уровне level
+   * (для самих источников level = 0).
+   */
+  template<typename OnVisit>
+  void Run(std::span<const int> sources, OnVisit &&on_visit);
+
+  /**
+   * @brief Расстояния от каждого источника: result[i * n + v], INT_MAXIMUS для недостижимых вершин.
+   */
+  std::vector<int> Distances(std::span<const int> sources);
+
+  /**
+   * @brief Сводка по каждому источнику без хранения строк расстояний.
+   */
+  std::vector<SourceStatistic> Statistics(std::span<const int> sources);
+};
+
+template<typename CurGraph, std::size_t Width>
+template<typename OnVisit>
+void MultiSourceBFS<CurGraph, Width>::Run(std::span<const int> sources, OnVisit &&on_visit) {
+  seen.assign(amount_vertex, SourceSet());
+  visit.assign(amount_vertex, SourceSet());
+  visit_next.assign(amount_vertex, SourceSet());
+  for (std::size_t i = 0; i < sources.size() && i < Width; i++) {
+    seen[sources[i]].Set(i);
+    visit[sources[i]].Set(i);
+  }
+  for (std::size_t top = 0; top < amount_vertex; top++) {
+    if (visit[top].Any()) on_visit(int(top), 0, visit[top]);
+  }
+
+  bool active = true;
+  for (int level = 1; active; level++) {
+    for (std::size_t top = 0; top < amount_vertex; top++) {
+      if (!visit[top].Any()) continue;
+      const SourceSet &cur = visit[top];
+      for (auto iter = graph.BeginEdges(top); iter != graph.EndEdges(top); ++iter) {
+        SourceSet &next = visit_next[graph.GetIndexVertex(iter)];
+        for (std::size_t i = 0; i < SourceSet::kWords; i++) next.words[i] |= cur.words[i];
+      }
+    }
+    // Старый visit больше не нужен: обнуляется в том же проходе, что и отбор новых источников
+    active = false;
+    for (std::size_t top = 0; top < amount_vertex; top++) {
+      visit[top] = SourceSet();
+      SourceSet &next = visit_next[top];
+      if (!next.Any()) continue;
+      for (std::size_t i = 0; i < SourceSet::kWords; i++) {
+        next.words[i] &= ~seen[top].words[i];
+        seen[top].words[i] |= next.words[i];
+      }
+      if (next.Any()) {
+        on_visit(int(top), level, next);
+        active = true;
+      }
+    }
+    visit.swap(visit_next);
+  }
+}
+
+template<typename CurGraph, std::size_t Width>
+std::vector<int> MultiSourceBFS<CurGraph, Width>::Distances(std::span<const int> sources) {
+  std::vector<int> result(sources.size() * amount_vertex, INT_MAXIMUS);
+  for (std::size_t batch = 0; batch < sources.size(); batch += Width) {
+    int *rows = result.data() + batch * amount_vertex;
+    Run(sources.subspan(batch, std::min(Width, sources.size() - batch)),
+        [&](int top, int level, const SourceSet &newly) {
+          newly.ForEach([&](std::size_t source) { rows[source * amount_vertex + top] = level; });
+        });
+  }
+  return result;
+}
+
+template<typename CurGraph, std::size_t Width>
+std::vector<typename MultiSourceBFS<CurGraph, Width>::SourceStatistic>
+MultiSourceBFS<CurGraph, Width>::Statistics(std::span<const int> sources) {
+  std::vector<SourceStatistic> result(sources.size());
+  for (std::size_t batch = 0; batch < sources.size(); batch += Width) {
+    SourceStatistic *stats = result.data() + batch;
+    Run(sources.subspan(batch, std::min(Width, sources.size() - batch)),
+        [&](int top, int level, const SourceSet &newly) {
+          newly.ForEach([&](std::size_t source) {
+            stats[source].sum_distance += level;
+            stats[source].amount_reached++;
+            stats[source].eccentricity = level;
+          });
+        });
   }
-  PrintDist();
+  return result;
 }
 
 template<typename CurGraph, std::enable_if_t<std::is_base_of_v<Edges<bool>, typename CurGraph::edges_type>,
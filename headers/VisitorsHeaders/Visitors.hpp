@@ -333,4 +333,20 @@ class DejkstraVisitor {
   void Dejkstra(int begin_top, CurGraph &graph);
 };
 
+/*
+ * true, если посетитель переопределил initialize_vertex_*. Если нет, хук пустой, и обход не делает цикл
+ * по всем вершинам графа: запрос стоит пропорционально числу затронутых вершин.
+ */
+template<typename CurVisitor, typename CurGraph>
+constexpr bool kOverridesInitializeDFS = !std::is_same_v<decltype(&CurVisitor::initialize_vertex_DFS),
+    decltype(&DFSVisitor<CurGraph>::initialize_vertex_DFS)>;
+
+template<typename CurVisitor, typename CurGraph>
+constexpr bool kOverridesInitializeBFS = !std::is_same_v<decltype(&CurVisitor::initialize_vertex_BFS),
+    decltype(&BFSVisitor<CurGraph>::initialize_vertex_BFS)>;
+
+template<typename CurVisitor, typename CurGraph>
+constexpr bool kOverridesInitializeDejkstra = !std::is_same_v<decltype(&CurVisitor::initialize_vertex_Dejkstra),
+    decltype(&DejkstraVisitor<CurGraph>::initialize_vertex_Dejkstra)>;
+
 #endif //GRAPHALKO_VISITORS_HPP
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #ifndef GRAPHALKO_ITERATORS_HPP
 #define GRAPHALKO_ITERATORS_HPP
+#include <bit>
+#include <cstdint>
 #include "Edges.hpp"
 
 template<typename CurEdges>
@@ -45,6 +47,9 @@ class NearTopIterator_TopEdges {
   reference operator*() {
     return *iter_near_tops;
   }
+  pointer operator->() {
+    return &*iter_near_tops;
+  }
   bool operator==(const NearTopIterator_TopEdges &other) {
     return other.iter_near_tops == this->iter_near_tops;
   }
@@ -53,11 +58,21 @@ class NearTopIterator_TopEdges {
   }
 };
 
+/**
+ * @brief Итератор по ребрам строки матрицы смежности.
+ *
+ * Рядом со строкой хранится битовая карта занятых столбцов, итератор переходит между установленными битами
+ * через countr_zero/countl_zero. Поэтому обход соседей вершины стоит O(n / 64 + степень), а не O(n).
+ * Конец строки - столбец amount_columns.
+ */
 template<typename T, bool is_const>
 class NearTopIterator_NearMatrix {
  protected:
   friend GraphStorageMatrixNear<T>;
-  std::vector<T>::iterator iter_near_tops;
+  T *row = nullptr;
+  const std::uint64_t *occupancy = nullptr;
+  std::size_t column = 0;
+  std::size_t amount_columns = 0;
 
  public:
   using value_type = T;
@@ -66,15 +81,33 @@ class NearTopIterator_NearMatrix {
   using difference_type = ssize_t;
   using iterator_category = std::bidirectional_iterator_tag;
 
-  explicit NearTopIterator_NearMatrix(std::vector<T>::iterator iter_near_tops) : iter_near_tops(iter_near_tops) {
+  NearTopIterator_NearMatrix() = default;
+
+  NearTopIterator_NearMatrix(T *row, const std::uint64_t *occupancy, std::size_t column, std::size_t amount_columns)
+      : row(row), occupancy(occupancy), column(column), amount_columns(amount_columns) {}
 
+  /**
+   * @brief Первый занятый столбец, не меньший from, или amount_columns.
+   */
+  static std::size_t NextOccupied(const std::uint64_t *occupancy, std::size_t from, std::size_t amount_columns) {
+    if (from >= amount_columns) return amount_columns;
+    std::size_t word = from >> 6;
+    std::uint64_t bits = occupancy[word] & (~std::uint64_t(0) << (from & 63));
+    const std::size_t amount_words = (amount_columns + 63) >> 6;
+    while (bits == 0) {
+      if (++word == amount_words) return amount_columns;
+      bits = occupancy[word];
+    }
+    return (word << 6) + std::countr_zero(bits);
   }
 
   NearTopIterator_NearMatrix<T, is_const> &operator--() {
-    iter_near_tops--;
-    while (iter_near_tops->where == INT_MAXIMUS) {
-      iter_near_tops--;
+    std::size_t word = (column - 1) >> 6;
+    std::uint64_t bits = occupancy[word] & (~std::uint64_t(0) >> (63 - ((column - 1) & 63)));
+    while (bits == 0) {
+      bits = occupancy[--word];
     }
+    column = (word << 6) + 63 - std::countl_zero(bits);
     return *this;
   }
   NearTopIterator_NearMatrix<T, is_const> operator--(int) {
@@ -83,10 +116,7 @@ class NearTopIterator_NearMatrix {
     return copy;
   }
   NearTopIterator_NearMatrix<T, is_const> &operator++() {
-    iter_near_tops++;
-    while (iter_near_tops->where == -1) {
-      iter_near_tops++;
-    }
+    column = NextOccupied(occupancy, column + 1, amount_columns);
     return *this;
   }
   NearTopIterator_NearMatrix<T, is_const> operator++(int) {
@@ -95,13 +125,16 @@ class NearTopIterator_NearMatrix {
     return copy;
   }
   reference operator*() {
-    return *iter_near_tops;
+    return row[column];
+  }
+  pointer operator->() {
+    return row + column;
   }
   bool operator==(const NearTopIterator_NearMatrix &other) {
-    return other.iter_near_tops == this->iter_near_tops;
+    return other.row == this->row && other.column == this->column;
   }
   bool operator!=(const NearTopIterator_NearMatrix &other) {
-    return this->iter_near_tops != other.iter_near_tops;
+    return !(*this == other);
   }
 };
 
@@ -7,6 +7,7 @@
 #include "test.hpp"
 #include "FlowVisitors.hpp"
 #include "LCAVisitors.hpp"
+#include "LCAIndex.hpp"
 #include "ShortestPathVisitors.hpp"
 
 template<typename CurGraph>
@@ -75,6 +76,67 @@ void MakeTestGraph_MatrixNear(const std::string &filename) {
   }
 }
 
+void MakeTestGraph_CSR(const std::string &filename) {
+  std::string line;
+  int amount_vetrex, amount_edges, answer, begin, end;
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      std::cerr << "\n" << "amount_vetrex = " << amount_vetrex << " amount_edges = " << amount_edges << " answer = "
+                << answer << "\n";
+      using edges_type = Edges_TopsEdges<bool>;
+      using graph_type = Graph<GraphStorageCSR<edges_type>>;
+      std::vector<std::pair<int, edges_type>> edge_list;
+      int vert_1, vert_2;
+      for (std::size_t i = 0; i < amount_edges; i++) {
+        myfile >> vert_1 >> vert_2;
+        edge_list.emplace_back(vert_1, edges_type(vert_2));
+      }
+      graph_type graph(GraphStorageCSR<edges_type>(amount_vetrex, edge_list));
+      graph.PrintGraph();
+      myfile >> begin >> end;
+      BFSShortestPathBetweenPair<graph_type> visitor(begin, end, amount_vetrex);
+      graph.BFS<BFSShortestPathBetweenPair<graph_type>>(begin, visitor);
+      assert((answer == visitor.deep[end]));
+    }
+    myfile.close();
+  }
+}
+
+void TestDejkstra_CSR(const std::string &filename) {
+  std::string line;
+  int amount_vetrex, amount_edges, answer, begin, end;
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      std::cerr << "\n" << "amount_vetrex = " << amount_vetrex << " amount_edges = " << amount_edges << " answer = "
+                << answer << "\n";
+      using edges_type = EdgesWeight_TopsEdges<int>;
+      using tops_graph_type = Graph<GraphStorageTopsEdges<edges_type>>;
+      using graph_type = Graph<GraphStorageCSR<edges_type>>;
+      tops_graph_type tops_graph(amount_vetrex);
+      CreateGraphfromIfStream<tops_graph_type>(amount_edges, myfile, tops_graph);
+      graph_type graph(GraphStorageCSR<edges_type>(tops_graph.GetStorage()));
+      myfile >> begin >> end;
+      DejkstraVisitor<graph_type> visitor(begin);
+      graph.Dejkstra<DejkstraVisitor<graph_type>>(begin, visitor);
+
+      int algo_ans = graph.GetDepth(end);
+      if(algo_ans == INT_MAXIMUS) {
+        algo_ans = -1;
+      }
+
+      assert((answer == algo_ans));
+    }
+    myfile.close();
+  }
+  std::cerr << "Tst Dejkstra CSR done" << "\n";
+}
+
 void TestDejkstra_TopEdges(const std::string &filename) {
   std::string line;
   int amount_vetrex, amount_edges, answer, begin, end;
@@ -105,6 +167,533 @@ void TestDejkstra_TopEdges(const std::string &filename) {
   std::cerr << "Tst Dejkstra done" << "\n";
 }
 
+template<typename CurQueue>
+void TestDejkstraQueue_TopEdges(const std::string &filename) {
+  std::string line;
+  int amount_vetrex, amount_edges, answer, begin, end;
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      std::cerr << "\n" << "amount_vetrex = " << amount_vetrex << " amount_edges = " << amount_edges << " answer = "
+                << answer << "\n";
+      using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+      graph_type graph(amount_vetrex);
+      CreateGraphfromIfStream<graph_type>(amount_edges, myfile, graph);
+      myfile >> begin >> end;
+      DejkstraVisitor<graph_type> visitor(begin);
+      graph.Dejkstra<DejkstraVisitor<graph_type>, CurQueue>(begin, visitor);
+
+      int algo_ans = graph.GetDepth(end);
+      if(algo_ans == INT_MAXIMUS) {
+        algo_ans = -1;
+      }
+
+      assert((answer == algo_ans));
+    }
+    myfile.close();
+  }
+}
+
+void TestBidirectionalDejkstra_TopEdges(const std::string &filename, bool orientation) {
+  std::string line;
+  int amount_vetrex, amount_edges, answer, begin, end;
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      std::cerr << "\n" << "amount_vetrex = " << amount_vetrex << " amount_edges = " << amount_edges << " answer = "
+                << answer << "\n";
+      using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+      graph_type graph(amount_vetrex, orientation);
+      CreateGraphfromIfStream<graph_type>(amount_edges, myfile, graph);
+      myfile >> begin >> end;
+
+      DejkstraVisitor<graph_type> visitor(begin);
+      graph.Dejkstra<DejkstraVisitor<graph_type>>(begin, visitor);
+      std::vector<int> dejkstra_depth;
+      for (std::size_t i = 0; i < graph.size(); i++) {
+        dejkstra_depth.push_back(graph.GetDepth(i));
+      }
+
+      std::vector<int> path;
+      for (int target = 0; target < amount_vetrex; target++) {
+        int dist = graph.BidirectionalDejkstra(begin, target, &path);
+        assert((dist == dejkstra_depth[target]));
+        if (dist != INT_MAXIMUS) {
+          assert((path.front() == begin && path.back() == target));
+        } else {
+          assert((path.empty()));
+        }
+      }
+
+      if (!orientation) {
+        int algo_ans = graph.BidirectionalDejkstra(begin, end);
+        if (algo_ans == INT_MAXIMUS) {
+          algo_ans = -1;
+        }
+        assert((answer == algo_ans));
+      }
+    }
+    myfile.close();
+  }
+  std::cerr << "Tst BidirectionalDejkstra done" << "\n";
+}
+
+using bfs_graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+
+// Несколько плотных кластеров, соединенных цепочкой, и недостижимый хвост
+bfs_graph_type MakeBFSTestGraph(bool orientation) {
+  const int amount_vetrex = 2000;
+  bfs_graph_type graph(amount_vetrex, orientation);
+  for (int i = 1; i < amount_vetrex - 50; i++) {
+    graph.AddEdge(int((i * 2654435761u) % i), i);
+    graph.AddEdge(i, int((i * 40503u) % amount_vetrex));
+    if (i % 3 == 0) graph.AddEdge(int((i * 7919u) % amount_vetrex), i);
+  }
+  return graph;
+}
+
+std::vector<int> ReferenceBFSDepth(bfs_graph_type &graph, int source = 0) {
+  std::vector<int> depth(graph.size(), INT_MAXIMUS);
+  std::vector<int> queue{source};
+  depth[source] = 0;
+  for (std::size_t i = 0; i < queue.size(); i++) {
+    for (auto iter = graph.BeginEdges(queue[i]); iter != graph.EndEdges(queue[i]); ++iter) {
+      int target = graph.GetIndexVertex(iter);
+      if (depth[target] == INT_MAXIMUS) {
+        depth[target] = depth[queue[i]] + 1;
+        queue.push_back(target);
+      }
+    }
+  }
+  return depth;
+}
+
+// Глубины совпадают с эталоном, предок стоит на предыдущем уровне и из него есть ребро в вершину
+void CheckBFSTree(bfs_graph_type &graph, const std::vector<int> &depth) {
+  for (int top = 0; top < int(graph.size()); top++) {
+    assert((graph.GetDepth(top) == depth[top]));
+    int predecessor = graph.GetPredecessor(top);
+    if (depth[top] == INT_MAXIMUS) {
+      assert((predecessor == POISON_VAL_ID_VERT));
+    } else if (top != 0) {
+      assert((depth[predecessor] == depth[top] - 1));
+      bool has_edge = false;
+      for (auto iter = graph.BeginEdges(predecessor); iter != graph.EndEdges(predecessor); ++iter) {
+        has_edge |= graph.GetIndexVertex(iter) == top;
+      }
+      assert((has_edge));
+    }
+  }
+}
+
+void TestDirectionOptimizingBFS(bool orientation, int alpha, int beta) {
+  auto graph = MakeBFSTestGraph(orientation);
+  std::vector<int> depth = ReferenceBFSDepth(graph);
+  graph.DirectionOptimizingBFS(0, alpha, beta);
+  CheckBFSTree(graph, depth);
+  std::cerr << "Tst DirectionOptimizingBFS done" << "\n";
+}
+
+class CountingParallelBFSVisitor : public BFSVisitor<bfs_graph_type> {
+ public:
+  std::vector<int> discovered;
+  std::vector<int> finished;
+  std::atomic<int> amount_tree_edges = 0;
+
+  explicit CountingParallelBFSVisitor(int amount_vetrex) : discovered(amount_vetrex, 0), finished(amount_vetrex, 0) {}
+
+  bool discover_vertex_BFS(vert_desc top, graph_type &graph) {
+    discovered[top]++;
+    return false;
+  }
+
+  void tree_edge_BFS(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    amount_tree_edges.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void finish_vertex_BFS(vert_desc top, graph_type &graph) {
+    finished[top]++;
+  }
+};
+
+void TestParallelBFS(bool orientation, std::size_t amount_threads) {
+  auto graph = MakeBFSTestGraph(orientation);
+  std::vector<int> depth = ReferenceBFSDepth(graph);
+  ThreadPool pool(amount_threads);
+  CountingParallelBFSVisitor visitor(graph.size());
+  graph.ParallelBFS(0, visitor, pool);
+  CheckBFSTree(graph, depth);
+
+  int amount_reached = 0;
+  for (std::size_t top = 0; top < graph.size(); top++) {
+    bool reached = depth[top] != INT_MAXIMUS;
+    amount_reached += reached;
+    assert((visitor.discovered[top] == int(reached) && visitor.finished[top] == int(reached)));
+  }
+  assert((visitor.amount_tree_edges == amount_reached - 1));
+  std::cerr << "Tst ParallelBFS done" << "\n";
+}
+
+// Потоки со своими контекстами одновременно обходят один граф; состояние графа при этом не меняется
+void TestTraversalContext(std::size_t amount_threads) {
+  auto graph = MakeBFSTestGraph(true);
+  graph.GetReverseEdges();
+  std::vector<int> default_depth = ReferenceBFSDepth(graph);
+  graph.DirectionOptimizingBFS(0);
+
+  const int amount_sources = 24;
+  std::vector<std::vector<int>> reference_depth;
+  for (int source = 0; source < amount_sources; source++) {
+    reference_depth.push_back(ReferenceBFSDepth(graph, source * 37));
+  }
+
+  std::vector<std::thread> workers;
+  for (std::size_t thread_id = 0; thread_id < amount_threads; thread_id++) {
+    workers.emplace_back([&, thread_id]() {
+      bfs_graph_type::context_type context;
+      BFSVisitor<bfs_graph_type> visitor;
+      for (int source = int(thread_id); source < amount_sources; source += int(amount_threads)) {
+        const std::vector<int> &depth = reference_depth[source];
+        graph.DirectionOptimizingBFS(source * 37, context);
+        for (std::size_t top = 0; top < graph.size(); top++) {
+          assert((context.GetDepth(top) == depth[top]));
+        }
+        graph.BFS(source * 37, visitor, context);
+        for (std::size_t top = 0; top < graph.size(); top++) {
+          assert((context.GetColor(top) == (depth[top] == INT_MAXIMUS ? 0 : 2)));
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  CheckBFSTree(graph, default_depth);
+  std::cerr << "Tst TraversalContext done" << "\n";
+}
+
+class StopAtTargetBFSVisitor : public BFSVisitor<bfs_graph_type> {
+ public:
+  int target;
+
+  explicit StopAtTargetBFSVisitor(int target) : target(target) {}
+
+  bool discover_vertex_BFS(vert_desc top, graph_type &graph) {
+    return top == target;
+  }
+};
+
+// Сброс по эпохам: значения прошлого запроса в том же контексте не видны, даже если новый запрос их не тронул
+void TestEpochContextReuse() {
+  auto graph = MakeBFSTestGraph(false);
+  bfs_graph_type::context_type context;
+  for (int source = 0; source < 5; source++) {
+    std::vector<int> depth = ReferenceBFSDepth(graph, source);
+    graph.DirectionOptimizingBFS(source, context);
+    for (std::size_t top = 0; top < graph.size(); top++) {
+      assert((context.GetDepth(top) == depth[top]));
+      if (depth[top] == INT_MAXIMUS) assert((context.GetPredecessor(top) == POISON_VAL_ID_VERT));
+    }
+
+    int target = 0;
+    while (target < int(graph.size()) && depth[target] != 2) target++;
+    assert((target < int(graph.size())));
+    StopAtTargetBFSVisitor visitor(target);
+    graph.BFS(source, visitor, context);
+    for (std::size_t top = 0; top < graph.size(); top++) {
+      if (depth[top] > 3) assert((context.GetColor(top) == 0));
+    }
+    assert((context.GetColor(target) == 1));
+  }
+  std::cerr << "Tst EpochContextReuse done" << "\n";
+}
+
+// Пишет события DFS тройками (вид, откуда, куда) и по хешу от вершины или ребра досрочно останавливает обход
+class RecordingDFSVisitor : public DFSVisitor<bfs_graph_type> {
+ public:
+  std::vector<int> events;
+  unsigned salt;
+
+  explicit RecordingDFSVisitor(unsigned salt) : salt(salt) {}
+
+  bool discover_vertex_DFS(vert_desc top, graph_type &graph) {
+    Record(0, top, top);
+    return Stop(top, top, 23);
+  }
+
+  bool tree_edge_DFS(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    Record(1, edge.first, edge.second);
+    return Stop(edge.first, edge.second, 11);
+  }
+
+  bool finish_edge(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    Record(2, edge.first, edge.second);
+    return Stop(edge.second, edge.first, 13);
+  }
+
+  void back_edge(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    Record(3, edge.first, edge.second);
+  }
+
+  void forward_or_cross_edge(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    Record(4, edge.first, edge.second);
+  }
+
+  void finish_vertex_DFS(vert_desc top, graph_type &graph) {
+    Record(5, top, top);
+  }
+
+ private:
+  void Record(int kind, int from, int to) {
+    events.insert(events.end(), {kind, from, to});
+  }
+
+  [[nodiscard]] bool Stop(int from, int to, unsigned modulo) const {
+    return salt != 0 && (unsigned(from) * 2654435761u + unsigned(to) * 40503u + salt) % modulo == 0;
+  }
+};
+
+// DFSIter выдает ту же последовательность событий, что и рекурсивный DFSRecr, в том числе при досрочных остановках
+void TestDFSIterMatchesRecr(bool orientation) {
+  for (unsigned seed = 0; seed < 200; seed++) {
+    const int amount_vetrex = 1 + int(seed % 37);
+    const int amount_edges = int(seed * 7919u % (3 * amount_vetrex + 1));
+    bfs_graph_type graph(amount_vetrex, orientation);
+    for (int i = 0; i < amount_edges; i++) {
+      unsigned hash = (seed + 1) * 2654435761u + unsigned(i) * 40503u;
+      graph.AddEdge(int(hash % amount_vetrex), int((hash >> 16) % amount_vetrex));
+    }
+
+    // Без остановок и с остановками в discover_vertex_DFS, tree_edge_DFS и finish_edge
+    for (unsigned salt : {0u, seed + 1}) {
+      RecordingDFSVisitor recursive(salt);
+      graph.ConstructColor();
+      graph.DFSRecr(0, recursive);
+
+      RecordingDFSVisitor iterative(salt);
+      graph.ConstructColor();
+      graph.DFSIter(0, iterative);
+      assert((recursive.events == iterative.events));
+    }
+  }
+  std::cerr << "Tst DFSIterMatchesRecr done" << "\n";
+}
+
+// Глубина цепочки порядка 10^6 переполнила бы стек рекурсивного обхода
+void TestDeepChainDFS() {
+  const int amount_vetrex = 1 << 20;
+  bfs_graph_type graph(amount_vetrex);
+  for (int i = 1; i < amount_vetrex; i++) {
+    graph.AddEdge(i - 1, i);
+  }
+
+  DFSLCADoubleUp<bfs_graph_type> visitor(0, amount_vetrex);
+  visitor.BeReadyForLCA(graph);
+  assert((visitor.GetAmountLevels() == std::bit_width(unsigned(amount_vetrex - 1))));
+  for (int i = 0; i < 64; i++) {
+    int u = int((i * 2654435761u) % amount_vetrex);
+    int v = int((i * 40503u + 17) % amount_vetrex);
+    assert((visitor.GetLCA(u, v) == std::min(u, v)));
+    assert((visitor.LSA_with_distance(u, v, graph) == std::abs(u - v)));
+  }
+  assert((graph.GetColor(amount_vetrex - 1) == 2));
+  std::cerr << "Tst DeepChainDFS done" << "\n";
+}
+
+// Пишет события BFS тройками (вид, откуда, куда) и проверяет цвета вершин в момент вызова
+class RecordingBFSVisitor : public BFSVisitor<bfs_graph_type> {
+ public:
+  enum Event { kExamineVertex, kDiscover, kExamineEdge, kTreeEdge, kNonTreeEdge, kGrayTarget, kBlackTarget, kFinish };
+  std::vector<int> events;
+
+  void examine_vertex_BFS(vert_desc top, graph_type &graph) {
+    Record(kExamineVertex, top, top);
+  }
+
+  bool discover_vertex_BFS(vert_desc top, graph_type &graph) {
+    Record(kDiscover, top, top);
+    return false;
+  }
+
+  void examine_edge_BFS(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    assert((graph.GetColor(edge.first) == 1));
+    Record(kExamineEdge, edge.first, edge.second);
+  }
+
+  void tree_edge_BFS(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    assert((graph.GetColor(edge.second) == 0));
+    Record(kTreeEdge, edge.first, edge.second);
+  }
+
+  void non_tree_edge(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    Record(kNonTreeEdge, edge.first, edge.second);
+  }
+
+  void gray_target(vert_desc top, graph_type &graph) {
+    Record(kGrayTarget, top, top);
+  }
+
+  void black_target(vert_desc top, graph_type &graph) {
+    Record(kBlackTarget, top, top);
+  }
+
+  void finish_vertex_BFS(vert_desc top, graph_type &graph) {
+    assert((graph.GetColor(top) == 2));
+    Record(kFinish, top, top);
+  }
+
+ private:
+  void Record(int kind, int from, int to) {
+    events.insert(events.end(), {kind, from, to});
+  }
+};
+
+// Порядок хуков BFS: examine_edge_BFS перед классификацией каждого ребра, черный цвет после просмотра всех ребер,
+// finish_vertex_BFS для каждой достижимой вершины
+void TestBFSEventOrder() {
+  using Visitor = RecordingBFSVisitor;
+  bfs_graph_type graph(5, true);
+  for (auto [from, to] : std::vector<std::pair<int, int>>{{0, 1}, {0, 2}, {1, 2}, {1, 0}, {2, 3}, {2, 1}, {3, 3}}) {
+    graph.AddEdge(from, to);
+  }
+
+  Visitor visitor;
+  graph.BFS(0, visitor);
+  const std::vector<int> expected = {
+      Visitor::kDiscover, 0, 0,
+      Visitor::kExamineEdge, 0, 1, Visitor::kTreeEdge, 0, 1,
+      Visitor::kExamineEdge, 0, 2, Visitor::kTreeEdge, 0, 2,
+      Visitor::kFinish, 0, 0,
+      Visitor::kExamineVertex, 1, 1, Visitor::kDiscover, 1, 1,
+      Visitor::kExamineEdge, 1, 2, Visitor::kNonTreeEdge, 1, 2, Visitor::kGrayTarget, 2, 2,
+      Visitor::kExamineEdge, 1, 0, Visitor::kNonTreeEdge, 1, 0, Visitor::kBlackTarget, 0, 0,
+      Visitor::kFinish, 1, 1,
+      Visitor::kExamineVertex, 2, 2, Visitor::kDiscover, 2, 2,
+      Visitor::kExamineEdge, 2, 3, Visitor::kTreeEdge, 2, 3,
+      Visitor::kExamineEdge, 2, 1, Visitor::kNonTreeEdge, 2, 1, Visitor::kBlackTarget, 1, 1,
+      Visitor::kFinish, 2, 2,
+      Visitor::kExamineVertex, 3, 3, Visitor::kDiscover, 3, 3,
+      Visitor::kExamineEdge, 3, 3, Visitor::kNonTreeEdge, 3, 3, Visitor::kGrayTarget, 3, 3,
+      Visitor::kFinish, 3, 3,
+  };
+  assert((visitor.events == expected));
+  assert((graph.GetColor(4) == 0));
+  std::cerr << "Tst BFSEventOrder done" << "\n";
+}
+
+class PathDepthBFSVisitor : public BFSVisitor<bfs_graph_type> {
+ public:
+  std::vector<int> depth;
+  int amount_finished = 0;
+
+  PathDepthBFSVisitor(int amount_vetrex, int source) : depth(amount_vetrex, INT_MAXIMUS) { depth[source] = 0; }
+
+  void tree_edge_BFS(edge_desc edge, edge_desc_iter iter, graph_type &graph) {
+    depth[edge.second] = depth[edge.first] + 1;
+  }
+
+  void finish_vertex_BFS(vert_desc top, graph_type &graph) {
+    amount_finished++;
+  }
+};
+
+// Путь порядка 10^6 вершин: фронт из одной вершины, число уровней равно длине пути
+void TestLongPathBFS() {
+  const int amount_vetrex = 1 << 20;
+  const int source = amount_vetrex / 3;
+  bfs_graph_type graph(amount_vetrex, false);
+  for (int i = 1; i < amount_vetrex; i++) {
+    graph.AddEdge(i - 1, i);
+  }
+
+  PathDepthBFSVisitor visitor(amount_vetrex, source);
+  graph.BFS(source, visitor);
+  assert((visitor.amount_finished == amount_vetrex));
+  for (int top = 0; top < amount_vetrex; top++) {
+    assert((visitor.depth[top] == std::abs(top - source)));
+    assert((graph.GetColor(top) == 2));
+  }
+  std::cerr << "Tst LongPathBFS done" << "\n";
+}
+
+template<std::size_t Width>
+void TestMultiSourceBFS(bool orientation) {
+  auto graph = MakeBFSTestGraph(orientation);
+  // Источников больше Width, есть повторы и недостижимые вершины хвоста
+  std::vector<int> sources;
+  for (int i = 0; i < 150; i++) {
+    sources.push_back(int((i * 2654435761u) % graph.size()));
+  }
+  sources.push_back(sources[3]);
+
+  MultiSourceBFS<bfs_graph_type, Width> engine(graph);
+  std::vector<int> distances = engine.Distances(sources);
+  auto statistics = engine.Statistics(sources);
+  for (std::size_t i = 0; i < sources.size(); i++) {
+    std::vector<int> depth = ReferenceBFSDepth(graph, sources[i]);
+    long long sum_distance = 0;
+    int amount_reached = 0, eccentricity = 0;
+    for (std::size_t top = 0; top < graph.size(); top++) {
+      assert((distances[i * graph.size() + top] == depth[top]));
+      if (depth[top] == INT_MAXIMUS) continue;
+      sum_distance += depth[top];
+      amount_reached++;
+      eccentricity = std::max(eccentricity, depth[top]);
+    }
+    assert((statistics[i].sum_distance == sum_distance));
+    assert((statistics[i].amount_reached == amount_reached));
+    assert((statistics[i].eccentricity == eccentricity));
+  }
+  std::cerr << "Tst MultiSourceBFS done" << "\n";
+}
+
+void TestDeltaStepping_TopEdges(const std::string &filename, std::size_t amount_threads) {
+  std::string line;
+  int amount_vetrex, amount_edges, answer, begin, end;
+  ThreadPool pool(amount_threads);
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      std::cerr << "\n" << "amount_vetrex = " << amount_vetrex << " amount_edges = " << amount_edges << " answer = "
+                << answer << "\n";
+      using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+      graph_type graph(amount_vetrex);
+      CreateGraphfromIfStream<graph_type>(amount_edges, myfile, graph);
+      myfile >> begin >> end;
+
+      DejkstraVisitor<graph_type> visitor(begin);
+      graph.Dejkstra<DejkstraVisitor<graph_type>>(begin, visitor);
+      std::vector<int> dejkstra_depth;
+      for (std::size_t i = 0; i < graph.size(); i++) {
+        dejkstra_depth.push_back(graph.GetDepth(i));
+      }
+
+      graph.DeltaStepping(begin, pool);
+      for (std::size_t i = 0; i < graph.size(); i++) {
+        assert((dejkstra_depth[i] == graph.GetDepth(i)));
+      }
+
+      int algo_ans = graph.GetDepth(end);
+      if(algo_ans == INT_MAXIMUS) {
+        algo_ans = -1;
+      }
+      assert((answer == algo_ans));
+    }
+    myfile.close();
+  }
+  std::cerr << "Tst DeltaStepping done" << "\n";
+}
+
+static_assert(std::is_same_v<DejkstraQueueSelector<EdgesBoundedWeight_TopsEdges<int, 16>>::type, DialBucketQueue<16>>);
+static_assert(std::is_same_v<DejkstraQueueSelector<EdgesWeight_TopsEdges<int>>::type, RadixHeap<>>);
+static_assert(std::is_same_v<DejkstraQueueSelector<EdgesWeight_TopsEdges<double>>::type, IndexedDaryHeap<4>>);
+
 void TestLCAUpDouble_TopEdges(const std::string &filename) {
   std::string line;
   int amount_vetrex, amount_edges, answer, begin, end;
@@ -130,6 +719,158 @@ void TestLCAUpDouble_TopEdges(const std::string &filename) {
   }
 }
 
+void TestLCAUpDoubleLevels(std::size_t amount_threads) {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  // Длинные цепочки с редкими ветвлениями: глубина дерева заметно больше log n
+  const int amount_vetrex = 600;
+  graph_type graph(amount_vetrex);
+  std::vector<int> depth(amount_vetrex, 0);
+  int max_depth = 0;
+  for (int i = 1; i < amount_vetrex; i++) {
+    int parent = (i % 7 == 0) ? int((i * 2654435761u) % i) : i - 1;
+    graph.AddEdge(parent, i);
+    depth[i] = depth[parent] + 1;
+    max_depth = std::max(max_depth, depth[i]);
+  }
+
+  ThreadPool pool(amount_threads);
+  DFSLCADoubleUp<graph_type> visitor(0, amount_vetrex);
+  visitor.BeReadyForLCA(graph, pool);
+  assert((visitor.GetAmountLevels() == std::bit_width(unsigned(max_depth))));
+  DFSLCAFarachColtonBender<graph_type> expected(0, amount_vetrex);
+  expected.PreprocessForLCA(graph);
+  for (int u = 0; u < amount_vetrex; u++) {
+    for (int v = 0; v < amount_vetrex; v++) {
+      int lca = expected.GetLCA(u, v, graph);
+      assert((visitor.GetLCA(u, v) == lca));
+      assert((visitor.LSA_with_distance(u, v, graph) == depth[u] + depth[v] - 2 * depth[lca]));
+    }
+  }
+  std::cerr << "Tst LCAUpDouble levels done" << "\n";
+}
+
+void TestLCATarjan_TopEdges(const std::string &filename) {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  int amount_vetrex, amount_edges, answer, begin, end;
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      graph_type graph(amount_vetrex);
+      CreateGraphfromIfStream<graph_type>(amount_edges, myfile, graph);
+      myfile >> begin >> end;
+
+      DFSLCADoubleUp<graph_type> expected(0, amount_vetrex);
+      expected.BeReadyForLCA(graph);
+      std::vector<std::pair<int, int>> queries{{begin, end}};
+      for (int u = 0; u < amount_vetrex; u++) {
+        for (int v = 0; v < amount_vetrex; v++) {
+          queries.emplace_back(u, v);
+        }
+      }
+      std::vector<int> lca(queries.size());
+      std::vector<int> distance(queries.size());
+      DFSLCATarjan<graph_type> visitor(0, amount_vetrex);
+      visitor.AnswerQueries(graph, queries, lca, distance);
+      assert((distance[0] == answer));
+      for (std::size_t i = 0; i < queries.size(); i++) {
+        assert((lca[i] == expected.GetLCA(queries[i].first, queries[i].second)));
+        assert((distance[i] == expected.LSA_with_distance(queries[i].first, queries[i].second, graph)));
+      }
+    }
+    myfile.close();
+  }
+  std::cerr << "Tst LCATarjan done" << "\n";
+}
+
+void TestHeavyLight() {
+  using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+  const int amount_vetrex = 300;
+  graph_type graph(amount_vetrex);
+  std::vector<int> parent(amount_vetrex, -1);
+  std::vector<int> weight(amount_vetrex, 0);
+  for (int i = 1; i < amount_vetrex; i++) {
+    parent[i] = (i % 5 == 0) ? int((i * 2654435761u) % i) : i - 1;
+    weight[i] = int((i * 40503u) % 201) - 100;
+    graph.AddEdge(parent[i], i, weight[i]);
+  }
+  auto depth = [&](int top) {
+    int result = 0;
+    for (; top != 0; top = parent[top]) result++;
+    return result;
+  };
+
+  DFSHeavyLight<graph_type> visitor(0, amount_vetrex);
+  visitor.BeReadyForPathQueries(graph);
+  for (int round = 0; round < 3; round++) {
+    for (int u = 0; u < amount_vetrex; u++) {
+      for (int v = 0; v < amount_vetrex; v += 7) {
+        // Путь проверяется подъемом по родителям от более глубокой вершины
+        int sum = 0, min = std::numeric_limits<int>::max(), max = std::numeric_limits<int>::lowest();
+        int a = u, b = v;
+        while (a != b) {
+          if (depth(a) < depth(b)) std::swap(a, b);
+          sum += weight[a];
+          min = std::min(min, weight[a]);
+          max = std::max(max, weight[a]);
+          a = parent[a];
+        }
+        auto result = visitor.QueryPath(u, v);
+        assert((visitor.GetLCA(u, v) == a));
+        assert((result.sum == sum && result.min == min && result.max == max));
+      }
+    }
+    for (int i = 1; i < amount_vetrex; i += 3 + round) {
+      weight[i] = int((i * 7919u + round) % 101) - 50;
+      visitor.SetEdgeWeight(i, parent[i], weight[i]);
+    }
+  }
+  std::cerr << "Tst HeavyLight done" << "\n";
+}
+
+void TestLCAIndexFile(const std::string &path) {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  const int amount_vetrex = 500;
+  graph_type graph(amount_vetrex);
+  for (int i = 1; i < amount_vetrex; i++) {
+    graph.AddEdge(int((i * 2654435761u) % i), i);
+  }
+  DFSLCAFarachColtonBender<graph_type> visitor(0, amount_vetrex);
+  visitor.PreprocessForLCA(graph);
+  SaveLCAIndex(visitor, path);
+
+  {
+    MappedLCAIndex index(path);
+    assert((index.Header().amount_vertex == std::uint64_t(amount_vetrex)));
+    assert((index.VerifyChecksum()));
+    for (int u = 0; u < amount_vetrex; u++) {
+      for (int v = 0; v < amount_vetrex; v++) {
+        assert((index.GetLCA(u, v) == visitor.GetLCA(u, v, graph)));
+      }
+    }
+  }
+
+  // Испорченный байт данных ловит контрольная сумма, испорченный заголовок - конструктор
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(sizeof(LCAIndexHeader) + 5);
+  file.put(char(0x7f));
+  file.flush();
+  assert((!MappedLCAIndex(path).VerifyChecksum()));
+  file.seekp(0);
+  file.put('X');
+  file.close();
+  bool thrown = false;
+  try {
+    MappedLCAIndex index(path);
+  } catch (const std::runtime_error &) {
+    thrown = true;
+  }
+  assert((thrown));
+  std::remove(path.c_str());
+  std::cerr << "Tst LCAIndexFile done" << "\n";
+}
+
 void TestLCAFrakBender_TopEdges(const std::string &filename) {
   std::string line;
   int amount_vetrex, amount_edges, answer, begin, end;
@@ -155,6 +896,114 @@ void TestLCAFrakBender_TopEdges(const std::string &filename) {
   }
 }
 
+void TestLCAFrakBenderBatch_TopEdges(const std::string &filename) {
+  std::string line;
+  int amount_vetrex, amount_edges, answer, begin, end;
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+      graph_type graph(amount_vetrex);
+      CreateGraphfromIfStream<graph_type>(amount_edges, myfile, graph);
+      myfile >> begin >> end;
+
+      DFSLCAFrakBender<graph_type> visitor(0, amount_vetrex);
+      visitor.PreprocessForLCAFrakBender(graph);
+      std::vector<std::pair<int, int>> queries{{begin, end}};
+      for (int u = 0; u < amount_vetrex; u++) {
+        for (int v = 0; v < amount_vetrex; v++) {
+          queries.emplace_back(u, v);
+        }
+      }
+      std::vector<int> answers(queries.size());
+      visitor.GetLCA(queries, answers);
+      assert((answers[0] == answer));
+      for (std::size_t i = 0; i < queries.size(); i++) {
+        assert((answers[i] == visitor.GetLCA(queries[i].first, queries[i].second, graph)));
+        assert((answers[i] == visitor.GetLCA(queries[i].second, queries[i].first, graph)));
+      }
+    }
+    myfile.close();
+  }
+  std::cerr << "Tst LCAFrakBender batch done" << "\n";
+}
+
+void TestLCAFarachColtonBender_TopEdges(const std::string &filename) {
+  using graph_type = Graph<GraphStorageTopsEdges<Edges_TopsEdges<bool>>>;
+  int amount_vetrex, amount_edges, answer, begin, end;
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      graph_type graph(amount_vetrex);
+      CreateGraphfromIfStream<graph_type>(amount_edges, myfile, graph);
+      myfile >> begin >> end;
+
+      DFSLCAFarachColtonBender<graph_type> visitor(0, amount_vetrex);
+      visitor.PreprocessForLCA(graph);
+      assert((visitor.GetLCA(begin, end, graph) == answer));
+    }
+    myfile.close();
+  }
+
+  // Дерево, в котором эйлеров обход занимает много блоков: сверка с разреженной таблицей на всех парах
+  const int amount_tree = 700;
+  graph_type tree(amount_tree);
+  for (int i = 1; i < amount_tree; i++) {
+    tree.AddEdge(int((i * 2654435761u) % i), i);
+  }
+  DFSLCAFarachColtonBender<graph_type> visitor(0, amount_tree);
+  visitor.PreprocessForLCA(tree);
+  DFSLCAFrakBender<graph_type> expected(0, amount_tree);
+  expected.PreprocessForLCAFrakBender(tree);
+  for (int u = 0; u < amount_tree; u++) {
+    for (int v = 0; v < amount_tree; v++) {
+      assert((visitor.GetLCA(u, v, tree) == expected.GetLCA(u, v, tree)));
+    }
+  }
+  std::cerr << "Tst LCAFarachColtonBender done" << "\n";
+}
+
+// Парные остаточные ребра: обратное к обратному - само ребро, Augment меняет поток пары на +delta и -delta.
+// Есть параллельные ребра и петля, у которой оба ребра пары лежат в одном списке
+void TestFlowReverseEdges(bool orientation) {
+  using graph_type = Graph<FlowNetworkStorageTopsEdges<EdgesFlow_TopsEdges<long long int>>>;
+  const int amount_vetrex = 4;
+  graph_type graph(amount_vetrex, orientation);
+  for (auto [from, to, weight] : std::vector<std::tuple<int, int, int>>{
+      {0, 1, 5}, {0, 1, 3}, {1, 0, 2}, {1, 2, 4}, {2, 2, 7}, {2, 3, 6}, {3, 0, 1}}) {
+    graph.AddEdge(from, to, weight);
+  }
+
+  int amount_edges = 0;
+  for (int top = 0; top < amount_vetrex; top++) {
+    for (auto iter = graph.BeginEdges(top); iter != graph.EndEdges(top); ++iter) {
+      amount_edges++;
+      auto reverse = graph.GetReverseEdge(iter);
+      assert((graph.GetReverseEdge(reverse) == iter));
+      assert((!(reverse == iter)));
+      assert((graph.GetIndexVertex(reverse) == top));
+      if (orientation) {
+        assert(((iter->weight == 0) != (reverse->weight == 0)));
+      } else {
+        assert((iter->weight == reverse->weight));
+      }
+
+      long long delta = top + 2;
+      long long flow = iter->flow;
+      long long reverse_flow = reverse->flow;
+      graph.Augment(iter, delta);
+      assert((iter->flow == flow + delta));
+      assert((reverse->flow == reverse_flow - delta));
+    }
+  }
+  assert((amount_edges == 14));
+  std::cerr << "Tst FlowReverseEdges done" << "\n";
+}
+
 void TestDinic_TopEdges(const std::string &filename) {
   std::string line;
   int amount_vetrex, amount_edges, answer, begin, end;
@@ -205,6 +1054,47 @@ void TestDinic_MatrixNear(const std::string &filename) {
   }
 }
 
+template<typename CurGraph>
+void TestPushRelabel(const std::string &filename) {
+  std::string line;
+  int amount_vetrex, amount_edges, answer, begin, end;
+
+  std::ifstream myfile(filename);
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges >> answer;
+      std::cerr << "\n" << "amount_vetrex = " << amount_vetrex << " amount_edges = " << amount_edges << " answer = "
+                << answer << "\n";
+      CurGraph graph(amount_vetrex, true);
+      CreateGraphfromIfStream<CurGraph>(amount_edges, myfile, graph);
+      myfile >> begin >> end;
+
+      HighestLabelPushRelabel<CurGraph> visitor(begin, end, amount_vetrex);
+      int ans = visitor.PushRelabel(begin, end, graph);
+      assert((answer == ans));
+
+      // Пропускная способность разреза равна потоку, а в ребрах графа лежит настоящий поток
+      assert((visitor.IsSourceSide(begin) && !visitor.IsSourceSide(end)));
+      long long cut_capacity = 0;
+      for (int top = 0; top < amount_vetrex; top++) {
+        long long balance = 0;
+        for (auto iter = graph.BeginEdges(top); iter != graph.EndEdges(top); ++iter) {
+          balance += (*iter).flow;
+          if (visitor.IsSourceSide(top) && !visitor.IsSourceSide(graph.GetIndexVertex(iter))) {
+            cut_capacity += (*iter).weight;
+          }
+        }
+        if (top != begin && top != end) {
+          assert((balance == 0));
+        }
+      }
+      assert((cut_capacity == answer));
+    }
+    myfile.close();
+  }
+  std::cerr << "Tst PushRelabel done" << "\n";
+}
+
 void TestDejkstra_MatrixNear(const std::string &filename) {
   std::string line;
   int amount_vetrex, amount_edges, answer, begin, end;
@@ -233,6 +1123,68 @@ void TestDejkstra_MatrixNear(const std::string &filename) {
   std::cerr << "Tst Dejkstra done" << "\n";
 }
 
+// Соседи из итераторов по битовой карте и вид GetMatrixNear совпадают с ячейками матрицы, в том числе после
+// роста буфера в AddTop
+void TestMatrixNearOccupancy(bool orientation) {
+  using storage_type = GraphStorageMatrixNear<EdgesWeight_MatrixNear<int>>;
+  using edges_type = storage_type::edges_type;
+  const int amount_vetrex = 130;
+  storage_type storage(amount_vetrex - 3, orientation);
+  std::vector<std::vector<int>> weight(amount_vetrex, std::vector<int>(amount_vetrex, 0));
+  auto add_edge = [&](int from, int to, int cur_weight) {
+    weight[from][to] = cur_weight;
+    if (!orientation) weight[to][from] = cur_weight;
+  };
+  for (int i = 0; i < 300; i++) {
+    int from = int((i * 2654435761u) % (amount_vetrex - 3));
+    int to = int((i * 40503u + 7) % (amount_vetrex - 3));
+    storage.AddEdge(from, to, i + 1);
+    add_edge(from, to, i + 1);
+  }
+  for (int top = amount_vetrex - 3; top < amount_vetrex; top++) {
+    std::vector<edges_type> edg(top, edges_type(POISON_VAL_ID_VERT, 0));
+    std::vector<edges_type> obrat(top, edges_type(POISON_VAL_ID_VERT, 0));
+    for (int i = top % 5; i < top; i += 17) {
+      edg[i] = edges_type(i, 1000 + i);
+      weight[top][i] = 1000 + i;
+      if (!orientation) weight[i][top] = 1000 + i;
+    }
+    for (int i = top % 3; i < top && orientation; i += 29) {
+      obrat[i] = edges_type(top, 2000 + i);
+      weight[i][top] = 2000 + i;
+    }
+    storage.AddTop(std::move(edg), std::move(obrat));
+  }
+  storage.AddEdge(5, amount_vetrex - 1, 7);
+  add_edge(5, amount_vetrex - 1, 7);
+
+  assert((storage.size() == std::size_t(amount_vetrex)));
+  auto matrix = storage.GetMatrixNear();
+  assert((matrix.size() == std::size_t(amount_vetrex)));
+  assert((reinterpret_cast<std::uintptr_t>(matrix.Data()) % 64 == 0 && matrix.Stride() * sizeof(edges_type) % 64 == 0));
+  for (int from = 0; from < amount_vetrex; from++) {
+    std::vector<int> expected;
+    for (int to = 0; to < amount_vetrex; to++) {
+      assert((storage.IsEdge(from, to) == (weight[from][to] != 0)));
+      assert((matrix[from][to] == weight[from][to]));
+      if (weight[from][to] != 0) expected.push_back(to);
+    }
+    std::vector<int> forward;
+    for (auto iter = storage.BeginEdges(from); iter != storage.EndEdges(from); ++iter) {
+      assert((storage.GetWeightFromIter(iter) == weight[from][storage.GetIndexVertex(iter)]));
+      forward.push_back(storage.GetIndexVertex(iter));
+    }
+    std::vector<int> backward;
+    for (auto iter = storage.EndEdges(from); iter != storage.BeginEdges(from);) {
+      --iter;
+      backward.push_back(storage.GetIndexVertex(iter));
+    }
+    std::reverse(backward.begin(), backward.end());
+    assert((forward == expected && backward == expected));
+  }
+  std::cerr << "Tst MatrixNearOccupancy done" << "\n";
+}
+
 void TestLCA_MatrixNear(const std::string &filename) {
   std::string line;
   int amount_vetrex, amount_edges, answer, begin, end;
@@ -290,6 +1242,38 @@ void TestLoydWarshell_TopEdges(const std::string &filename) {
   std::cerr << "Tst TestLoydWarshell_TopEdges done" << "\n";
 }
 
+void TestAPSPModes_TopEdges(const std::string &filename, std::size_t amount_threads) {
+  std::string line;
+  int amount_vetrex, amount_edges, answer, begin, end;
+  ThreadPool pool(amount_threads);
+  std::ifstream myfile(filename);
+
+  if (myfile.is_open()) {
+    while (!myfile.eof()) {
+      myfile >> amount_vetrex >> amount_edges;
+      using graph_type = Graph<GraphStorageTopsEdges<EdgesWeight_TopsEdges<int>>>;
+      graph_type graph(amount_vetrex);
+      CreateGraphfromIfStream<graph_type>(amount_edges, myfile, graph);
+      std::vector<FloydWarshallVisitor<graph_type>> visitors;
+      for (APSPMode mode : {APSPMode::kAuto, APSPMode::kFloydWarshall, APSPMode::kParallelFloydWarshall,
+                            APSPMode::kParallelDejkstra}) {
+        visitors.emplace_back(amount_vetrex);
+        visitors.back().FloydWarshell(graph, pool, mode);
+      }
+      myfile >> begin >> end >> answer;
+      do {
+        for (auto &visitor : visitors) {
+          assert((answer == visitor.GetDist(begin, end)));
+        }
+        myfile >> begin >> end >> answer;
+      } while (begin != -1);
+    }
+    myfile.close();
+  }
+
+  std::cerr << "Tst TestAPSPModes_TopEdges done" << "\n";
+}
+
 void TestFordFUlkerson_TopEdges(const std::string &filename) {
   std::string line;
   int amount_vetrex, amount_edges, begin, end;
@@ -421,20 +1405,65 @@ void TestLoydWarshell_MatrixNear(const std::string &filename) {
 int main() {
   MakeTestGraph_TopEdges("./tests/ForShortestPath/simple_test.txt");
   MakeTestGraph_MatrixNear("./tests/ForShortestPath/simple_test.txt");
+  MakeTestGraph_CSR("./tests/ForShortestPath/simple_test.txt");
 
   TestLCAUpDouble_TopEdges("./tests/ForLCA/LCAWitDistance_test.txt");
+  TestLCAUpDoubleLevels(1);
+  TestLCAUpDoubleLevels(3);
+  TestLCATarjan_TopEdges("./tests/ForLCA/LCAWitDistance_test.txt");
+  TestHeavyLight();
+  TestLCAIndexFile("./LCAIndex_test.bin");
   TestLCAFrakBender_TopEdges("./tests/ForLCA/LCA_test.txt");
+  TestLCAFrakBenderBatch_TopEdges("./tests/ForLCA/LCA_test.txt");
+  TestLCAFarachColtonBender_TopEdges("./tests/ForLCA/LCA_test.txt");
 
   TestLCA_MatrixNear("./tests/ForLCA/LCAWitDistance_test.txt");
 
   TestDejkstra_TopEdges("./tests/ForShortestPath/Dejkstra_test.txt");
   TestDejkstra_MatrixNear("./tests/ForShortestPath/Dejkstra_test.txt");
+  TestMatrixNearOccupancy(false);
+  TestMatrixNearOccupancy(true);
+  TestDejkstra_CSR("./tests/ForShortestPath/Dejkstra_test.txt");
+  TestDejkstraQueue_TopEdges<LazyPriorityQueue<>>("./tests/ForShortestPath/Dejkstra_test.txt");
+  TestDejkstraQueue_TopEdges<IndexedDaryHeap<2>>("./tests/ForShortestPath/Dejkstra_test.txt");
+  TestDejkstraQueue_TopEdges<IndexedDaryHeap<8>>("./tests/ForShortestPath/Dejkstra_test.txt");
+  TestDejkstraQueue_TopEdges<RadixHeap<>>("./tests/ForShortestPath/Dejkstra_test.txt");
+  TestDejkstraQueue_TopEdges<DialBucketQueue<16>>("./tests/ForShortestPath/Dejkstra_test.txt");
+  TestDirectionOptimizingBFS(false, 15, 18);
+  TestDirectionOptimizingBFS(true, 15, 18);
+  TestDirectionOptimizingBFS(false, 1 << 30, 1);
+  TestDirectionOptimizingBFS(true, 1 << 30, 1);
+  TestDirectionOptimizingBFS(true, 1, 1 << 30);
+  TestParallelBFS(false, 1);
+  TestParallelBFS(true, 3);
+  TestTraversalContext(1);
+  TestTraversalContext(4);
+  TestEpochContextReuse();
+  TestDFSIterMatchesRecr(false);
+  TestDFSIterMatchesRecr(true);
+  TestDeepChainDFS();
+  TestBFSEventOrder();
+  TestLongPathBFS();
+  TestMultiSourceBFS<64>(false);
+  TestMultiSourceBFS<256>(true);
+  TestDeltaStepping_TopEdges("./tests/ForShortestPath/Dejkstra_test.txt", 1);
+  TestDeltaStepping_TopEdges("./tests/ForShortestPath/Dejkstra_test.txt", 4);
+  TestBidirectionalDejkstra_TopEdges("./tests/ForShortestPath/Dejkstra_test.txt", false);
+  TestBidirectionalDejkstra_TopEdges("./tests/ForShortestPath/Dejkstra_test.txt", true);
 
   TestLoydWarshell_TopEdges("./tests/ForShortestPath/LoydWarshell_test.txt");
   TestLoydWarshell_MatrixNear("./tests/ForShortestPath/LoydWarshell_test.txt");
+  TestAPSPModes_TopEdges("./tests/ForShortestPath/LoydWarshell_test.txt", 1);
+  TestAPSPModes_TopEdges("./tests/ForShortestPath/LoydWarshell_test.txt", 3);
 
+  TestFlowReverseEdges(true);
+  TestFlowReverseEdges(false);
   TestDinic_TopEdges("./tests/ForFlowNetwork/FlowNetwork_test.txt");
   TestDinic_MatrixNear("./tests/ForFlowNetwork/FlowNetwork_test.txt");
+  TestPushRelabel<Graph<FlowNetworkStorageTopsEdges<EdgesFlow_TopsEdges<long long int>>>>(
+      "./tests/ForFlowNetwork/FlowNetwork_test.txt");
+  TestPushRelabel<Graph<FlowNetworkStorageMatrixNear<EdgesFlow_MatrixNear<int>>>>(
+      "./tests/ForFlowNetwork/FlowNetwork_test.txt");
   TestFordFUlkerson_TopEdges("./tests/ForFlowNetwork/FlowNetwork_test.txt");
   TestFordFUlkerson_MatrixNear("./tests/ForFlowNetwork/FlowNetwork_test.txt");
   TestAdmondKarp_TopEdges("./tests/ForFlowNetwork/FlowNetwork_test.txt");
@@ -6,36 +6,40 @@
 template<typename CurGraphStorage>
 template<typename... Args>
 void Graph<CurGraphStorage>::AddEdge(int f, int s, Args &&... construct_args) {
+  reverse_edges_ready = false;
   storage.AddEdge(f, s, construct_args...); //std::forward realize
 }
 
 template<typename CurGraphStorage>
 void Graph<CurGraphStorage>::AddEdge(int f, int s, weight_type weight) {
+  reverse_edges_ready = false;
   storage.AddEdge(f, s, weight); //std::forward realize
 }
 
 
 template<typename CurGraphStorage>
 template<typename CurDFSVisitor>
-void Graph<CurGraphStorage>::DFS(int begin_top, CurDFSVisitor &visitor) {
+void Graph<CurGraphStorage>::DFS(int begin_top, CurDFSVisitor &visitor, context_type &context) {
   static_assert(std::is_base_of_v<DFSVisitor<Graph<CurGraphStorage>>, CurDFSVisitor>);
 
-  storage.ConstructColor();
+  context.ConstructColor(storage.size());
 
-  for (std::size_t i = 0; i < storage.size(); i++) {
-    visitor.initialize_vertex_DFS(i, *this);
+  if constexpr (kOverridesInitializeDFS<CurDFSVisitor, Graph<CurGraphStorage>>) {
+    for (std::size_t i = 0; i < storage.size(); i++) {
+      visitor.initialize_vertex_DFS(i, *this);
+    }
   }
   visitor.start_vertex(begin_top, *this);
 
-  DFSRecr<CurDFSVisitor>(begin_top, visitor);
+  DFSIter<CurDFSVisitor>(begin_top, visitor, context);
 }
 
 template<typename CurGraphStorage>
 template<typename CurDFSVisitor>
-void Graph<CurGraphStorage>::DFSRecr(int begin_top, CurDFSVisitor &visitor) {
+void Graph<CurGraphStorage>::DFSRecr(int begin_top, CurDFSVisitor &visitor, context_type &context) {
   static_assert(std::is_base_of_v<DFSVisitor<Graph<CurGraphStorage>>, CurDFSVisitor>);
 
-  storage.GetColor(begin_top) = 1;
+  context.GetColor(begin_top) = 1;
   if (visitor.discover_vertex_DFS(begin_top, *this)) return;
 
   auto near_top_iter_begin = storage.BeginEdges(begin_top);
@@ -51,17 +55,17 @@ void Graph<CurGraphStorage>::DFSRecr(int begin_top, CurDFSVisitor &visitor) {
   while ((near_top_iter_begin != near_top_iter_end)) {
     int index_vert_from_iter = storage.GetIndexVertex(near_top_iter_begin);
 
-    if (storage.GetColor(near_top_iter_begin) == 0) {
+    if (context.GetColor(index_vert_from_iter) == 0) {
       if (visitor.tree_edge_DFS({begin_top, index_vert_from_iter}, near_top_iter_begin, *this)) {
         near_top_iter_begin++;
         continue;
       }
-      DFSRecr(index_vert_from_iter, visitor);
+      DFSRecr(index_vert_from_iter, visitor, context);
       if (visitor.finish_edge({begin_top, index_vert_from_iter}, near_top_iter_begin, *this)) {
         return;
       }
 
-    } else if (storage.GetColor(near_top_iter_begin) == 1) {
+    } else if (context.GetColor(index_vert_from_iter) == 1) {
       visitor.back_edge({begin_top, index_vert_from_iter}, near_top_iter_begin, *this);
     } else {
       visitor.forward_or_cross_edge({begin_top, index_vert_from_iter},
@@ -70,132 +74,587 @@ void Graph<CurGraphStorage>::DFSRecr(int begin_top, CurDFSVisitor &visitor) {
     }
     near_top_iter_begin++;
   }
-  storage.GetColor(begin_top) = 2;
+  context.GetColor(begin_top) = 2;
   visitor.finish_vertex_DFS(begin_top, *this);
   visitor.DFSVisitFinishVertex(begin_top, *this);
 }
 
+/*
+ * Повторяет порядок событий DFSRecr, но вместо рекурсии хранит явный стек кадров (вершина, текущее ребро).
+ * Кадр текущей вершины держится в локальных переменных и попадает в стек только при спуске к ребенку.
+ * Возврат из рекурсивного вызова соответствует снятию кадра со стека и вызову finish_edge у родителя;
+ * если finish_edge вернул true, родитель тоже снимается без finish_vertex_DFS, как и в DFSRecr.
+ */
+template<typename CurGraphStorage>
+template<typename CurDFSVisitor>
+void Graph<CurGraphStorage>::DFSIter(int begin_top, CurDFSVisitor &visitor, context_type &context) {
+  static_assert(std::is_base_of_v<DFSVisitor<Graph<CurGraphStorage>>, CurDFSVisitor>);
+
+  context.dfs_stack.clear();
+  context.GetColor(begin_top) = 1;
+  if (visitor.discover_vertex_DFS(begin_top, *this)) return;
+
+  int cur_top = begin_top;
+  auto near_top_iter = storage.BeginEdges(begin_top);
+  auto near_top_iter_end = storage.EndEdges(begin_top);
+
+  // Вызывает finish_edge для текущего ребра cur_top. Возвращает false, если обход закончен.
+  auto return_from_child = [&]() {
+    while (visitor.finish_edge({cur_top, storage.GetIndexVertex(near_top_iter)}, near_top_iter, *this)) {
+      if (context.dfs_stack.empty()) return false;
+      cur_top = context.dfs_stack.back().top;
+      near_top_iter = context.dfs_stack.back().iter;
+      near_top_iter_end = context.dfs_stack.back().end;
+      context.dfs_stack.pop_back();
+    }
+    ++near_top_iter;
+    return true;
+  };
+
+  while (true) {
+    if (near_top_iter == near_top_iter_end) {
+      context.GetColor(cur_top) = 2;
+      visitor.finish_vertex_DFS(cur_top, *this);
+      visitor.DFSVisitFinishVertex(cur_top, *this);
+      if (context.dfs_stack.empty()) return;
+      cur_top = context.dfs_stack.back().top;
+      near_top_iter = context.dfs_stack.back().iter;
+      near_top_iter_end = context.dfs_stack.back().end;
+      context.dfs_stack.pop_back();
+      if (!return_from_child()) return;
+      continue;
+    }
+
+    int index_vert_from_iter = storage.GetIndexVertex(near_top_iter);
+    visitor.examine_edge_DFS({cur_top, index_vert_from_iter}, near_top_iter, *this);
+
+    int target_color = context.GetColor(index_vert_from_iter);
+    if (target_color == 0) {
+      if (visitor.tree_edge_DFS({cur_top, index_vert_from_iter}, near_top_iter, *this)) {
+        ++near_top_iter;
+        continue;
+      }
+      context.GetColor(index_vert_from_iter) = 1;
+      if (visitor.discover_vertex_DFS(index_vert_from_iter, *this)) {
+        if (!return_from_child()) return;
+        continue;
+      }
+      context.dfs_stack.push_back({cur_top, near_top_iter, near_top_iter_end});
+      cur_top = index_vert_from_iter;
+      near_top_iter = storage.BeginEdges(cur_top);
+      near_top_iter_end = storage.EndEdges(cur_top);
+      continue;
+    } else if (target_color == 1) {
+      visitor.back_edge({cur_top, index_vert_from_iter}, near_top_iter, *this);
+    } else {
+      visitor.forward_or_cross_edge({cur_top, index_vert_from_iter}, near_top_iter, *this);
+    }
+    ++near_top_iter;
+  }
+}
+
 template<typename CurGraphStorage>
 template<typename CurBFSVisitor>
-void Graph<CurGraphStorage>::BFS(int begin_top, CurBFSVisitor &visitor) {
+void Graph<CurGraphStorage>::BFS(int begin_top, CurBFSVisitor &visitor, context_type &context) {
   static_assert(std::is_base_of_v<BFSVisitor<Graph<CurGraphStorage>>, CurBFSVisitor>);
-  this->bfs_deq.clear();
+  context.bfs_frontier.clear();
+  context.bfs_frontier.Reserve(storage.size());
 
-  storage.ConstructColor();
-  for (std::size_t i = 0; i < storage.size(); i++) {
-    visitor.initialize_vertex_BFS(i, *this);
+  context.ConstructColor(storage.size());
+  if constexpr (kOverridesInitializeBFS<CurBFSVisitor, Graph<CurGraphStorage>>) {
+    for (std::size_t i = 0; i < storage.size(); i++) {
+      visitor.initialize_vertex_BFS(i, *this);
+    }
   }
 
-  BFSRecr<CurBFSVisitor>(begin_top, visitor);
+  BFSFrontier<CurBFSVisitor>(begin_top, visitor, context);
 }
 
+/*
+ * Обход идет по уровням: за итерацию внешнего цикла обрабатывается весь текущий фронт, а вершины
+ * следующего уровня дописываются в тот же кольцевой буфер. Стек не растет с размером графа.
+ */
 template<typename CurGraphStorage>
 template<typename CurBFSVisitor>
-void Graph<CurGraphStorage>::BFSRecr(int begin_top, CurBFSVisitor &visitor) {
+void Graph<CurGraphStorage>::BFSFrontier(int begin_top, CurBFSVisitor &visitor, context_type &context) {
   static_assert(std::is_base_of_v<BFSVisitor<Graph<CurGraphStorage>>, CurBFSVisitor>);
 
-  storage.GetColor(begin_top) = 1;
+  context.GetColor(begin_top) = 1;
+  context.bfs_frontier.push_back(begin_top);
 
-  auto near_top_iter_begin = storage.BeginEdges(begin_top);
-  auto near_top_iter_end = storage.EndEdges(begin_top);
-  if (visitor.discover_vertex_BFS(begin_top, *this)) return;
-  while ((near_top_iter_begin != near_top_iter_end)) {
-    visitor.examine_edge_BFS({begin_top, storage.GetIndexVertex(near_top_iter_begin)}, near_top_iter_begin, *this);
-    near_top_iter_begin++;
+  while (!context.bfs_frontier.empty()) {
+    std::size_t level_size = context.bfs_frontier.size();
+    for (std::size_t level_pos = 0; level_pos < level_size; level_pos++) {
+      int cur_top = context.bfs_frontier.front();
+      context.bfs_frontier.pop_front();
+
+      if (cur_top != begin_top) {
+        visitor.examine_vertex_BFS(cur_top, *this);
+      }
+      if (visitor.discover_vertex_BFS(cur_top, *this)) return;
+
+      auto near_top_iter_begin = storage.BeginEdges(cur_top);
+      auto near_top_iter_end = storage.EndEdges(cur_top);
+      while ((near_top_iter_begin != near_top_iter_end)) {
+        int index_vert_from_iter = storage.GetIndexVertex(near_top_iter_begin);
+        visitor.examine_edge_BFS({cur_top, index_vert_from_iter}, near_top_iter_begin, *this);
+
+        if (context.GetColor(index_vert_from_iter) == 0) {
+          visitor.tree_edge_BFS({cur_top, index_vert_from_iter},
+                                near_top_iter_begin,
+                                *this); //TODO: делать bool
+          if (context.GetColor(index_vert_from_iter) == 0) {
+            context.GetColor(index_vert_from_iter) = 1;
+            context.bfs_frontier.push_back(index_vert_from_iter);
+          }
+        } else {
+          visitor.non_tree_edge({cur_top, index_vert_from_iter}, near_top_iter_begin, *this);
+          if (context.GetColor(index_vert_from_iter) == 1) {
+            visitor.gray_target(index_vert_from_iter, *this);
+          } else {
+            visitor.black_target(index_vert_from_iter, *this);
+          }
+        }
+        ++near_top_iter_begin;
+      }
+      context.GetColor(cur_top) = 2;
+      visitor.finish_vertex_BFS(cur_top, *this);
+    }
   }
+}
 
-  near_top_iter_begin = storage.BeginEdges(begin_top);
-  near_top_iter_end = storage.EndEdges(begin_top);
-  while ((near_top_iter_begin != near_top_iter_end)) {
-    int index_vert_from_iter = storage.GetIndexVertex(near_top_iter_begin);
+/*
+ * Фронт хранится списком на шагах сверху вниз и битовой картой на шагах снизу вверх. Шаг снизу вверх перебирает
+ * непосещенные вершины и их входящие ребра (GetReverseEdges) и останавливается на первом соседе из фронта, поэтому
+ * на средних уровнях, где фронт покрывает большую часть графа, почти не смотрит ребер в уже посещенные вершины.
+ * scout - число ребер, выходящих из фронта, edges_to_check - оценка числа ребер, еще не просмотренных сверху вниз.
+ * Глубины совпадают с обычным BFS; предком становится первый найденный сосед из предыдущего уровня.
+ */
+template<typename CurGraphStorage>
+void Graph<CurGraphStorage>::DirectionOptimizingBFS(int begin_top, context_type &context, int alpha, int beta) {
+  const ReverseAdjacency<weight_type> &reverse = GetReverseEdges();
+  const std::size_t amount_vertex = storage.size();
+  const std::size_t amount_words = (amount_vertex + 63) / 64;
 
-    if (storage.GetColor(near_top_iter_begin) == 0) {
-      visitor.tree_edge_BFS({begin_top, index_vert_from_iter},
-                            near_top_iter_begin,
-                            *this); //TODO: делать bool
-      if (storage.GetColor(near_top_iter_begin) == 0) {
-        storage.GetColor(near_top_iter_begin) = 1;
-        bfs_deq.emplace_back(begin_top, index_vert_from_iter);
+  context.ConstructDepth(storage.size());
+  context.ConstructPredecessor(amount_vertex, POISON_VAL_ID_VERT);
+  context.GetDepth(begin_top) = 0;
+  context.GetPredecessor(begin_top) = begin_top;
+
+  std::vector<int> frontier{begin_top};
+  std::vector<int> next_frontier;
+  std::vector<std::uint64_t> frontier_bits(amount_words);
+  std::vector<std::uint64_t> next_bits(amount_words);
+  long long edges_to_check = static_cast<long long>(reverse.AmountEdges());
+  long long scout = static_cast<long long>(reverse.OutDegree(begin_top));
+  int level = 0;
+
+  while (!frontier.empty()) {
+    if (scout > edges_to_check / alpha) {
+      std::fill(frontier_bits.begin(), frontier_bits.end(), 0);
+      for (int top : frontier) {
+        frontier_bits[top >> 6] |= std::uint64_t(1) << (top & 63);
+      }
+      std::size_t awake = frontier.size();
+      std::size_t old_awake;
+      do {
+        old_awake = awake;
+        awake = 0;
+        std::fill(next_bits.begin(), next_bits.end(), 0);
+        for (std::size_t top = 0; top < amount_vertex; top++) {
+          if (context.GetDepth(top) != INT_MAXIMUS) continue;
+          for (auto edge = reverse.BeginEdges(top); edge != reverse.EndEdges(top); ++edge) {
+            if (frontier_bits[edge->from >> 6] >> (edge->from & 63) & 1) {
+              context.GetDepth(top) = level + 1;
+              context.GetPredecessor(top) = edge->from;
+              next_bits[top >> 6] |= std::uint64_t(1) << (top & 63);
+              awake++;
+              break;
+            }
+          }
+        }
+        frontier_bits.swap(next_bits);
+        level++;
+      } while (awake >= old_awake || awake > amount_vertex / beta);
+
+      frontier.clear();
+      scout = 0;
+      for (std::size_t word = 0; word < amount_words; word++) {
+        for (std::uint64_t bits = frontier_bits[word]; bits != 0; bits &= bits - 1) {
+          int top = static_cast<int>(word * 64 + std::countr_zero(bits));
+          frontier.push_back(top);
+          scout += static_cast<long long>(reverse.OutDegree(top));
+        }
       }
     } else {
-      visitor.non_tree_edge({begin_top, index_vert_from_iter}, near_top_iter_begin, *this);
-      if (storage.GetColor(near_top_iter_begin) == 1) {
-        visitor.gray_target(index_vert_from_iter, *this);
-      } else {
-        visitor.black_target(index_vert_from_iter, *this);
+      edges_to_check -= scout;
+      scout = 0;
+      next_frontier.clear();
+      for (int top : frontier) {
+        for (auto iter = storage.BeginEdges(top); iter != storage.EndEdges(top); ++iter) {
+          int target = storage.GetIndexVertex(iter);
+          if (context.GetDepth(target) == INT_MAXIMUS) {
+            context.GetDepth(target) = level + 1;
+            context.GetPredecessor(target) = top;
+            next_frontier.push_back(target);
+            scout += static_cast<long long>(reverse.OutDegree(target));
+          }
+        }
       }
+      frontier.swap(next_frontier);
+      level++;
     }
-    near_top_iter_begin++;
   }
-  if (bfs_deq.empty()) return;
+}
 
-  auto next_top = bfs_deq.front();
-  if (next_top.first != begin_top) {
-    visitor.finish_vertex_BFS(begin_top, *this);
+/*
+ * Потоки разбирают фронт кусками по kChunk вершин через общий атомарный курсор, так что вершины с большой
+ * степенью не оставляют остальные потоки без работы. Перед compare-exchange цвет читается обычной атомарной
+ * загрузкой: на средних уровнях почти все цели уже захвачены, и дорогая запись в кэш-линию не нужна.
+ */
+template<typename CurGraphStorage>
+template<typename CurBFSVisitor>
+void Graph<CurGraphStorage>::ParallelBFS(int begin_top, CurBFSVisitor &visitor, ThreadPool &pool, context_type &context) {
+  static_assert(std::is_base_of_v<BFSVisitor<Graph<CurGraphStorage>>, CurBFSVisitor>);
+  static constexpr std::size_t kChunk = 64;
+  const std::size_t amount_vertex = storage.size();
+
+  context.ConstructColor(amount_vertex);
+  context.ConstructDepth(amount_vertex);
+  context.ConstructPredecessor(amount_vertex, POISON_VAL_ID_VERT);
+  // Цвета захватываются атомарно из разных потоков, поэтому метки эпох проставляются заранее
+  context.color.Materialize();
+  if constexpr (kOverridesInitializeBFS<CurBFSVisitor, Graph<CurGraphStorage>>) {
+    for (std::size_t i = 0; i < amount_vertex; i++) {
+      visitor.initialize_vertex_BFS(i, *this);
+    }
   }
-  storage.GetColor(next_top.second) = 2;
-  bfs_deq.pop_front();
-  visitor.examine_vertex_BFS(next_top.second, *this);
+  context.GetColor(begin_top) = 1;
+  context.GetDepth(begin_top) = 0;
+  context.GetPredecessor(begin_top) = begin_top;
+  if (visitor.discover_vertex_BFS(begin_top, *this)) return;
+
+  std::vector<int> frontier{begin_top};
+  std::vector<int> next_frontier;
+  std::vector<std::vector<int>> local_frontier(pool.size());
+  std::vector<std::size_t> local_offset(pool.size() + 1);
+  std::atomic<bool> stop = false;
+  int level = 0;
+
+  while (!frontier.empty() && !stop.load(std::memory_order_relaxed)) {
+    std::atomic<std::size_t> cursor = 0;
+    pool.RunOnAll([&](std::size_t thread_id) {
+      std::vector<int> &local = local_frontier[thread_id];
+      local.clear();
+      while (true) {
+        std::size_t chunk_begin = cursor.fetch_add(kChunk, std::memory_order_relaxed);
+        if (chunk_begin >= frontier.size()) break;
+        std::size_t chunk_end = std::min(frontier.size(), chunk_begin + kChunk);
+        for (std::size_t i = chunk_begin; i < chunk_end; i++) {
+          int top = frontier[i];
+          for (auto iter = storage.BeginEdges(top); iter != storage.EndEdges(top); ++iter) {
+            int target = storage.GetIndexVertex(iter);
+            visitor.examine_edge_BFS({top, target}, iter, *this);
+            std::atomic_ref<int> color(context.GetColor(target));
+            int expected = 0;
+            if (color.load(std::memory_order_relaxed) != 0
+                || !color.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+              continue;
+            }
+            context.GetDepth(target) = level + 1;
+            context.GetPredecessor(target) = top;
+            local.push_back(target);
+            visitor.tree_edge_BFS({top, target}, iter, *this);
+            if (visitor.discover_vertex_BFS(target, *this)) stop.store(true, std::memory_order_relaxed);
+          }
+          visitor.finish_vertex_BFS(top, *this);
+        }
+      }
+    });
 
-  BFSRecr(next_top.second, visitor);
+    for (std::size_t thread_id = 0; thread_id < pool.size(); thread_id++) {
+      local_offset[thread_id + 1] = local_offset[thread_id] + local_frontier[thread_id].size();
+    }
+    next_frontier.resize(local_offset[pool.size()]);
+    pool.RunOnAll([&](std::size_t thread_id) {
+      std::copy(local_frontier[thread_id].begin(), local_frontier[thread_id].end(),
+                next_frontier.begin() + local_offset[thread_id]);
+    });
+    frontier.swap(next_frontier);
+    level++;
+  }
 }
 
 template<typename CurGraphStorage>
-template<typename CurDejkstraVisitor>
-void Graph<CurGraphStorage>::Dejkstra(int begin_top, CurDejkstraVisitor &visitor) {
+template<typename CurDejkstraVisitor, typename CurQueue>
+void Graph<CurGraphStorage>::Dejkstra(int begin_top, CurDejkstraVisitor &visitor, context_type &context) {
   static_assert(std::is_base_of_v<DejkstraVisitor<Graph<CurGraphStorage>>, CurDejkstraVisitor>);
 
-  storage.ConstructColor();
-  storage.ConstructDepth();
-  storage.ConstructPredecessor();
-  for (std::size_t i = 0; i < storage.size(); i++) {
-    visitor.initialize_vertex_Dejkstra(i, *this);
+  context.ConstructColor(storage.size());
+  context.ConstructDepth(storage.size());
+  context.ConstructPredecessor(storage.size());
+  if constexpr (kOverridesInitializeDejkstra<CurDejkstraVisitor, Graph<CurGraphStorage>>) {
+    for (std::size_t i = 0; i < storage.size(); i++) {
+      visitor.initialize_vertex_Dejkstra(i, *this);
+    }
   }
-  storage.GetColor(begin_top) = 1;
-  storage.GetDepth(begin_top) = 0;
+  context.GetColor(begin_top) = 1;
+  context.GetDepth(begin_top) = 0;
   if (visitor.discover_vertex_Dejkstra(begin_top, *this)) return;
-  std::priority_queue<std::pair<int, int>> dist_queue;
+  CurQueue dist_queue(storage.size());
 
-  dist_queue.emplace(0, begin_top);
+  dist_queue.Push(begin_top, 0);
 
   while (!dist_queue.empty()) {
-    auto v_pair = dist_queue.top();
-    dist_queue.pop();
-    int v_vert = v_pair.second;
-    int v_dist = -v_pair.first;
-    int deep_v_vert = storage.GetDepth(v_vert);
-
-    if (deep_v_vert < v_dist) {
-      std::cerr << "continue\n";
-      continue;
-    } else if (deep_v_vert > v_dist) {
-      std::cerr << "EEEEEEEERRRRRRRRRRRRRRRRROOOOOOOOOOOOOOOORRRRRRRRRRR\n";
-    }
-    visitor.examine_vertex_Dejkstra(v_dist, *this);
+    auto [v_dist, v_vert] = dist_queue.Top();
+    dist_queue.Pop();
+
+    // устаревшая пара из очереди без уменьшения ключа
+    if (context.GetDepth(v_vert) < v_dist) continue;
+
+    visitor.examine_vertex_Dejkstra(v_vert, *this);
     auto near_top_iter_begin = storage.BeginEdges(v_vert);
     auto near_top_iter_end = storage.EndEdges(v_vert);
     while ((near_top_iter_begin != near_top_iter_end)) {
       int index_vert_from_iter = storage.GetIndexVertex(near_top_iter_begin);
-      visitor.examine_edge_Dejkstra({begin_top, index_vert_from_iter},
+      visitor.examine_edge_Dejkstra({v_vert, index_vert_from_iter},
                                     near_top_iter_begin,
                                     *this);
 
-      if (GetWeightFromIter(near_top_iter_begin) + v_dist < storage.GetDepth(near_top_iter_begin)) {
-        storage.GetDepth(near_top_iter_begin) = GetWeightFromIter(near_top_iter_begin) + v_dist;
-        storage.GetPredecessor(near_top_iter_begin) = v_vert;
-        visitor.edge_relaxed({begin_top, index_vert_from_iter}, near_top_iter_begin, *this);
-        dist_queue.push({-(v_dist + GetWeightFromIter(near_top_iter_begin)),
-                         index_vert_from_iter});
-        if (storage.GetColor(near_top_iter_begin) == 0) {
-          storage.GetColor(near_top_iter_begin) = 1;
+      int new_dist = v_dist + GetWeightFromIter(near_top_iter_begin);
+      if (new_dist < context.GetDepth(index_vert_from_iter)) {
+        context.GetDepth(index_vert_from_iter) = new_dist;
+        context.GetPredecessor(index_vert_from_iter) = v_vert;
+        visitor.edge_relaxed({v_vert, index_vert_from_iter}, near_top_iter_begin, *this);
+        dist_queue.Push(index_vert_from_iter, new_dist);
+        if (context.GetColor(index_vert_from_iter) == 0) {
+          context.GetColor(index_vert_from_iter) = 1;
           visitor.discover_vertex_Dejkstra(index_vert_from_iter, *this);
         }
       } else {
-        visitor.edge_not_relaxed({begin_top, index_vert_from_iter}, near_top_iter_begin, *this);
+        visitor.edge_not_relaxed({v_vert, index_vert_from_iter}, near_top_iter_begin, *this);
+      }
+      ++near_top_iter_begin;
+    }
+    context.GetColor(v_vert) = 2;
+    visitor.finish_vertex_Dejkstra(v_vert, *this);
+  }
+}
+
+/*
+ * Параллельный delta-stepping. Вершины разбиты между потоками пула по остатку id % size(), корзина i содержит
+ * вершины с расстоянием в [i * delta, (i + 1) * delta). Каждая фаза делится барьером на две части: сначала потоки
+ * просматривают ребра своих вершин текущей корзины и складывают запросы на релаксацию в буфер потока-владельца
+ * конца ребра, затем каждый владелец применяет запросы к своим вершинам. Так depth и predecessor пишет только
+ * владелец вершины и синхронизация не нужна (во время просмотра depth только читается, без записи меток эпох,
+ * поэтому запросы, которые заведомо не улучшат расстояние, отбрасываются сразу). Легкие ребра (вес <= delta)
+ * релаксируются, пока корзина не опустеет, тяжелые - один раз для всех вершин, удаленных из корзины.
+ */
+template<typename CurGraphStorage>
+void Graph<CurGraphStorage>::DeltaStepping(int begin_top, ThreadPool &pool, context_type &context, int delta) {
+  struct Request {
+    int top;
+    int dist;
+    int predecessor;
+  };
+
+  const std::size_t amount_threads = pool.size();
+  const std::size_t amount_vertex = storage.size();
+
+  if (delta <= 0) {
+    long long sum_weight = 0;
+    std::size_t amount_edges = 0;
+    for (std::size_t i = 0; i < amount_vertex; i++) {
+      for (auto iter = storage.BeginEdges(i); iter != storage.EndEdges(i); ++iter) {
+        sum_weight += GetWeightFromIter(iter);
+        amount_edges++;
       }
-      near_top_iter_begin++;
     }
-    storage.GetColor(begin_top) = 2;
-    visitor.finish_vertex_Dejkstra(begin_top, *this);
+    delta = std::max<long long>(1, amount_edges == 0 ? 1 : sum_weight / amount_edges);
   }
-}
\ No newline at end of file
+
+  context.ConstructColor(storage.size());
+  context.ConstructDepth(storage.size());
+  context.ConstructPredecessor(storage.size());
+
+  std::vector<std::vector<std::vector<int>>> buckets(amount_threads);
+  std::vector<std::vector<std::vector<Request>>> requests(amount_threads,
+                                                          std::vector<std::vector<Request>>(amount_threads));
+  std::vector<std::vector<int>> removed(amount_threads);
+
+  auto owner = [&](int top) { return static_cast<std::size_t>(top) % amount_threads; };
+  auto push_to_bucket = [&](std::size_t thread_id, int top, int dist) {
+    std::size_t index = dist / delta;
+    if (buckets[thread_id].size() <= index) buckets[thread_id].resize(index + 1);
+    buckets[thread_id][index].push_back(top);
+  };
+  auto apply_requests = [&](std::size_t thread_id) {
+    for (std::size_t producer = 0; producer < amount_threads; producer++) {
+      for (const Request &request : requests[producer][thread_id]) {
+        if (request.dist < context.GetDepth(request.top)) {
+          context.GetDepth(request.top) = request.dist;
+          context.GetPredecessor(request.top) = request.predecessor;
+          push_to_bucket(thread_id, request.top, request.dist);
+        }
+      }
+      requests[producer][thread_id].clear();
+    }
+  };
+  auto relax_edges = [&](std::size_t thread_id, int top, bool light) {
+    int top_dist = context.GetDepth(top);
+    for (auto iter = storage.BeginEdges(top); iter != storage.EndEdges(top); ++iter) {
+      int weight = GetWeightFromIter(iter);
+      int target = storage.GetIndexVertex(iter);
+      if ((weight <= delta) == light && top_dist + weight < std::as_const(context).GetDepth(target)) {
+        requests[thread_id][owner(target)].push_back({target, top_dist + weight, top});
+      }
+    }
+  };
+
+  context.GetDepth(begin_top) = 0;
+  push_to_bucket(owner(begin_top), begin_top, 0);
+
+  std::size_t cur_bucket = 0;
+  while (true) {
+    std::size_t next_bucket = SIZE_MAX;
+    for (std::size_t thread_id = 0; thread_id < amount_threads; thread_id++) {
+      for (std::size_t i = cur_bucket; i < buckets[thread_id].size() && i < next_bucket; i++) {
+        if (!buckets[thread_id][i].empty()) {
+          next_bucket = i;
+          break;
+        }
+      }
+    }
+    if (next_bucket == SIZE_MAX) break;
+    cur_bucket = next_bucket;
+
+    bool bucket_empty = false;
+    while (!bucket_empty) {
+      pool.RunOnAll([&](std::size_t thread_id) {
+        if (buckets[thread_id].size() <= cur_bucket) return;
+        std::vector<int> frontier;
+        frontier.swap(buckets[thread_id][cur_bucket]);
+        for (int top : frontier) {
+          if (context.GetDepth(top) / delta != static_cast<int>(cur_bucket)) continue;
+          if (context.GetColor(top) != 2) {
+            context.GetColor(top) = 2;
+            removed[thread_id].push_back(top);
+          }
+          relax_edges(thread_id, top, true);
+        }
+      });
+      pool.RunOnAll(apply_requests);
+
+      bucket_empty = true;
+      for (std::size_t thread_id = 0; thread_id < amount_threads; thread_id++) {
+        if (buckets[thread_id].size() > cur_bucket && !buckets[thread_id][cur_bucket].empty()) {
+          bucket_empty = false;
+        }
+      }
+    }
+
+    pool.RunOnAll([&](std::size_t thread_id) {
+      for (int top : removed[thread_id]) {
+        relax_edges(thread_id, top, false);
+      }
+      removed[thread_id].clear();
+    });
+    pool.RunOnAll(apply_requests);
+    cur_bucket++;
+  }
+}
+
+/*
+ * Двунаправленная Дейкстра: прямой поиск из begin_top пишет в depth/predecessor контекста, обратный из end_top -
+ * в context.backward_depth/context.backward_predecessor и идет по входящим ребрам (для неориентированного графа - по обычным).
+ * На каждом шаге продвигается поиск с меньшим ключом в вершине очереди. mu - длина лучшего найденного пути через
+ * ребро между двумя областями; поиск останавливается, как только сумма ключей в вершинах очередей не меньше mu.
+ * Возвращает расстояние или INT_MAXIMUS, если end_top недостижима; при path != nullptr пишет в него путь.
+ */
+template<typename CurGraphStorage>
+template<typename CurQueue>
+int Graph<CurGraphStorage>::BidirectionalDejkstra(int begin_top, int end_top, context_type &context, std::vector<int> *path) {
+  context.ConstructDepth(storage.size());
+  context.ConstructPredecessor(storage.size());
+  context.backward_depth.Reset(storage.size(), INT_MAXIMUS);
+  context.backward_predecessor.Reset(storage.size(), POISON_VAL_ID_VERT);
+  if (storage.orientation) GetReverseEdges();
+
+  CurQueue forward_queue(storage.size());
+  CurQueue backward_queue(storage.size());
+  context.GetDepth(begin_top) = 0;
+  context.GetPredecessor(begin_top) = begin_top;
+  context.backward_depth[end_top] = 0;
+  context.backward_predecessor[end_top] = end_top;
+  forward_queue.Push(begin_top, 0);
+  backward_queue.Push(end_top, 0);
+
+  int best_dist = begin_top == end_top ? 0 : INT_MAXIMUS;
+  int meet_top = begin_top == end_top ? begin_top : POISON_VAL_ID_VERT;
+
+  while (!forward_queue.empty() && !backward_queue.empty()) {
+    auto forward_top = forward_queue.Top();
+    auto backward_top = backward_queue.Top();
+    if (forward_top.first + backward_top.first >= best_dist) break;
+
+    if (forward_top.first <= backward_top.first) {
+      forward_queue.Pop();
+      auto [v_dist, v_vert] = forward_top;
+      if (context.GetDepth(v_vert) < v_dist) continue;
+      for (auto iter = storage.BeginEdges(v_vert); iter != storage.EndEdges(v_vert); ++iter) {
+        int target = storage.GetIndexVertex(iter);
+        int new_dist = v_dist + GetWeightFromIter(iter);
+        if (new_dist < context.GetDepth(target)) {
+          context.GetDepth(target) = new_dist;
+          context.GetPredecessor(target) = v_vert;
+          forward_queue.Push(target, new_dist);
+        }
+        if (context.backward_depth[target] != INT_MAXIMUS && new_dist + context.backward_depth[target] < best_dist) {
+          best_dist = new_dist + context.backward_depth[target];
+          meet_top = target;
+        }
+      }
+    } else {
+      backward_queue.Pop();
+      auto [v_dist, v_vert] = backward_top;
+      if (context.backward_depth[v_vert] < v_dist) continue;
+      auto relax_backward = [&](int source, int weight) {
+        int new_dist = v_dist + weight;
+        if (new_dist < context.backward_depth[source]) {
+          context.backward_depth[source] = new_dist;
+          context.backward_predecessor[source] = v_vert;
+          backward_queue.Push(source, new_dist);
+        }
+        if (context.GetDepth(source) != INT_MAXIMUS && new_dist + context.GetDepth(source) < best_dist) {
+          best_dist = new_dist + context.GetDepth(source);
+          meet_top = source;
+        }
+      };
+      if (storage.orientation) {
+        for (auto edge = reverse_edges.BeginEdges(v_vert); edge != reverse_edges.EndEdges(v_vert); ++edge) {
+          relax_backward(edge->from, edge->weight);
+        }
+      } else {
+        for (auto iter = storage.BeginEdges(v_vert); iter != storage.EndEdges(v_vert); ++iter) {
+          relax_backward(storage.GetIndexVertex(iter), GetWeightFromIter(iter));
+        }
+      }
+    }
+  }
+
+  if (path != nullptr) {
+    path->clear();
+    if (meet_top != POISON_VAL_ID_VERT) {
+      for (int top = meet_top; top != begin_top; top = context.GetPredecessor(top)) {
+        path->push_back(top);
+      }
+      path->push_back(begin_top);
+      std::reverse(path->begin(), path->end());
+      for (int top = meet_top; top != end_top; ) {
+        top = context.backward_predecessor[top];
+        path->push_back(top);
+      }
+    }
+  }
+  return best_dist;
+}